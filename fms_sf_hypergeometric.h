@@ -45,15 +45,29 @@ namespace fms::sf {
 	}
 	static_assert(equal_precision<double>(1.0, 1.0001, 4));
 
+	// method used by Hypergeometric::value
+	enum class method {
+		series,     // partial sums
+		wynn,       // Wynn epsilon acceleration of partial sums
+		reflection, // 0F0(x) = 1/0F0(-x)
+		scaling,    // 0F0(x) = 0F0(x/2)^2
+		kummer,     // 1F1(a;b;x) = e^x 1F1(b - a;b;-x)
+		asymptotic, // 1F1(a;b;x) ~ Gamma(b)/Gamma(a) e^x x^(a - b) 2F0(b - a, 1 - a;;1/x)
+	};
+
 	// primitive implementation of general hypergeometric function
 	template<class X, size_t P, size_t Q>
 	class Hypergeometric {
-		template<class X, size_t N> using list = std::array<X,N>;
+		template<class Y, size_t N> using list = std::array<Y,N>;
 
 		const list<X,P> a;
 		const list<X,Q> b;
 
 	public:
+		// value, last correction, small terms, iterations, method
+		using result = std::tuple<X, X, int, int, method>;
+		static constexpr int max_terms = 128; // for wynn
+
 		constexpr Hypergeometric(const list<X, P>& a, const list<X, Q>& b)
 			: a(a), b(b)
 		{ }
@@ -67,9 +81,9 @@ namespace fms::sf {
 
 			return F;
 		}
-		
-		// policy based convergence
-		constexpr std::tuple<X, X, int, int> value(X x, X eps = sqrt_eps<X>, int skip = 4, int terms = 100) const
+
+		// policy based convergence of partial sums
+		constexpr result series(X x, X eps = sqrt_eps<X>, int skip = 4, int terms = 100) const
 		{
 			X n = 0;  // current n
 			X an = 1; // (a)_n
@@ -84,7 +98,7 @@ namespace fms::sf {
 
 			// if (a)_n = 0 then all follwing terms are 0
 			while (an and ignore and terms - iters) {
-				X dF = (an / bn) * xn / n_;
+				dF = (an / bn) * xn / n_;
 
 				for (X ai : a) {
 					an *= ai + n;
@@ -95,7 +109,7 @@ namespace fms::sf {
 				xn *= x;
 				n_ *= ++n;
 				pFq += dF;
-				maxF = maxF > max(maxF, abs(pFq));
+				maxF = max(maxF, abs(pFq));
 
 				if (abs(dF) < maxF * eps) {
 					++small;
@@ -108,13 +122,143 @@ namespace fms::sf {
 				++iters;
 			}
 
-			return std::tuple(pFq, dF, small, iters);
+			return result(pFq, dF, small, iters, method::series);
+		}
+
+		// Wynn epsilon algorithm applied to the partial sums.
+		// If the term limit is reached before skip consecutive small corrections then small is 0.
+		constexpr result wynn(X x, X eps = sqrt_eps<X>, int skip = 4, int terms = 100) const
+		{
+			list<X, max_terms> e{}; // lower diagonal of the epsilon table
+			X n = 0, an = 1, bn = 1, xn = 1, n_ = 1;
+			X S = 0; // partial sum
+			X F = 0, dF = 0;
+			int ignore = skip, small = 0, iters = 0;
+
+			terms = terms < max_terms ? terms : max_terms;
+			while (ignore and terms - iters) {
+				X t = (an / bn) * xn / n_;
+				S += t;
+				if (t == 0) { // terminating series
+					return result(S, 0, small, iters, method::wynn);
+				}
+				for (X ai : a) {
+					an *= ai + n;
+				}
+				for (X bi : b) {
+					bn *= bi + n;
+				}
+				xn *= x;
+				n_ *= ++n;
+
+				// e_{k+1}^{(n-1)} = e_{k-1}^{(n)} + 1/(e_k^{(n)} - e_k^{(n-1)}) along the counter-diagonal
+				e[iters] = S;
+				X e2 = 0;
+				for (int j = iters; j > 0; --j) {
+					X e1 = e2;
+					e2 = e[j - 1];
+					X d = e[j] - e2;
+					e[j - 1] = d == 0 ? std::numeric_limits<X>::max() : e1 + 1 / d;
+				}
+				X F_ = (iters & 1) ? e[1] : e[0];
+				dF = F_ - F;
+				F = F_;
+				++iters;
+
+				if (abs(dF) < max(X(1), abs(F)) * eps) {
+					++small;
+					--ignore;
+				}
+				else {
+					ignore = skip;
+				}
+			}
+			if (ignore) { // did not converge
+				small = 0;
+			}
+
+			return result(F, dF, small, iters, method::wynn);
+		}
+
+		// 1F1(a;b;x) for large x > 0 if the asymptotic series converges to eps.
+		result asymptotic(X x, X eps = sqrt_eps<X>, int terms = 100) const
+			requires (P == 1 and Q == 1)
+		{
+			X a_ = b[0] - a[0], b_ = 1 - a[0]; // 2F0(b - a, 1 - a;;1/x)
+			X n = 0, t = 1, S = 1;
+			int iters = 1;
+
+			if (a[0] <= 0 or b[0] <= 0 or x <= 0) {
+				return result(0, std::numeric_limits<X>::infinity(), 0, 0, method::asymptotic);
+			}
+
+			while (t and abs(t) >= eps * abs(S) and terms - iters) {
+				X t_ = t * (a_ + n) * (b_ + n) / ((n + 1) * x);
+				if (abs(t_) > abs(t)) { // diverging
+					break;
+				}
+				t = t_;
+				S += t;
+				++n;
+				++iters;
+			}
+
+			X F = S * std::exp(std::lgamma(b[0]) - std::lgamma(a[0]) + x + (a[0] - b[0]) * std::log(x));
+
+			return result(F, t * F / S, 0, iters, method::asymptotic);
+		}
+
+		// automatic method selection based on P, Q, and x
+		constexpr result value(X x, X eps = sqrt_eps<X>, int skip = 4, int terms = 100) const
+		{
+			if constexpr (P == 0 and Q == 0) {
+				if (x < 0) {
+					auto [F, dF, small, iters, m] = value(-x, eps, skip, terms);
+
+					return result(1 / F, -dF / (F * F), small, iters, method::reflection);
+				}
+				if (x > 1) {
+					int k = 0;
+					for (; x > 1; ++k) {
+						x /= 2;
+					}
+					auto [F, dF, small, iters, m] = series(x, eps, skip, terms);
+					for (; k; --k) {
+						dF *= 2 * F;
+						F *= F;
+					}
+
+					return result(F, dF, small, iters, method::scaling);
+				}
+			}
+			else if constexpr (P == 1 and Q == 1) {
+				if (x < 0) {
+					auto [F, dF, small, iters, m] = Hypergeometric<X, 1, 1>({ b[0] - a[0] }, { b[0] }).value(-x, eps, skip, terms);
+					X ex = std::get<0>(Hypergeometric<X, 0, 0>({}, {}).value(x, eps, skip, terms));
+
+					return result(ex * F, ex * dF, small, iters, method::kummer);
+				}
+				if (x > asymptotic_x and !std::is_constant_evaluated()) {
+					auto F = asymptotic(x, eps, terms);
+					if (abs(std::get<1>(F)) < eps * abs(std::get<0>(F))) {
+						return F;
+					}
+				}
+			}
+			else if constexpr (P > Q) {
+				if (x < 0) {
+					return wynn(x, eps, skip, terms);
+				}
+			}
+
+			return series(x, eps, skip, terms);
 		}
+		static constexpr X asymptotic_x = 20; // smallest x to try asymptotic expansion
 	};
 	constexpr Hypergeometric<double, 0, 0> F_00({}, {});
 	constexpr auto F0 = get<0>(F_00.value(0));
 	static_assert(F0 == 1);
-	constexpr auto F1 = std::get<0>(F_00.value(1));
+	constexpr auto F1 = std::get<0>(F_00.value(1, std::numeric_limits<double>::epsilon()));
 	static_assert(equal_precision(F1, 2.71828182845904523536, -15));
 	
 	// pFq(a,b,x) = sum_n (a_1)_n ... (a_p)_n/((b_1)_n ... (b_q)_n) x^n/n!
@@ -121,4 +121,65 @@ int test_hypergeometric()
 }
 int test_hypergeometric_d = test_hypergeometric<double>();
 int test_hypergeometric_f = test_hypergeometric<float>();
-#endif // 0
\ No newline at end of file
+#endif // 0
+
+template<class X>
+int test_hypergeometric_method()
+{
+	constexpr X eps = sqrt_eps<X>;
+	auto rel = [](X F, X G) { return abs(F - G) / std::max(X(1), abs(G)); };
+
+	// 0F0(x) = exp(x)
+	{
+		Hypergeometric<X, 0, 0> F_00({}, {});
+		for (X x : { X(-20), X(-5), X(-0.5), X(0.5), X(5), X(50) }) {
+			auto [F, dF, small, iters, m] = F_00.value(x);
+			assert(abs(F - std::exp(x)) <= 10 * eps * std::exp(x));
+			assert(m == (x < 0 ? method::reflection : x > 1 ? method::scaling : method::series));
+			assert(iters < 30);
+		}
+		assert(abs(fms::sf::exp(X(-20)) - std::exp(X(-20))) <= 10 * eps * std::exp(X(-20)));
+	}
+	// 1F1(1;2;x) = (e^x - 1)/x
+	{
+		Hypergeometric<X, 1, 1> F_11({ X(1) }, { X(2) });
+		for (X x : { X(-30), X(-2), X(2), X(40) }) {
+			auto [F, dF, small, iters, m] = F_11.value(x);
+			assert(rel(F, std::expm1(x) / x) <= 10 * eps);
+			assert(m == (x < 0 ? method::kummer : x > F_11.asymptotic_x ? method::asymptotic : method::series));
+			assert(iters < 50);
+		}
+	}
+	// asymptotic branch agrees with many terms of the series
+	{
+		Hypergeometric<X, 1, 1> F_11({ X(0.5) }, { X(1.5) });
+		auto [F, dF, small, iters, m] = F_11.value(30);
+		assert(m == method::asymptotic);
+		assert(iters < 40);
+		auto [G, dG, small_, iters_, m_] = F_11.series(30, std::numeric_limits<X>::epsilon(), 4, 1000);
+		assert(m_ == method::series);
+		assert(iters_ > 50);
+		assert(rel(F, G) <= 10 * eps * abs(G));
+	}
+	// (1 + x)^a = 1F0(-a;;-x) outside the disk of convergence
+	{
+		for (X x : { X(0.5), X(1.5), X(3) }) {
+			X F = pow1p<X>(x, X(0.5));
+			assert(rel(F, std::sqrt(1 + x)) <= 10 * eps);
+		}
+		auto [F, dF, small, iters, m] = Hypergeometric<X, 1, 0>({ X(-0.5) }, {}).value(-3);
+		assert(m == method::wynn);
+		assert(iters < 40);
+		assert(small > 0);
+		// term limit reached before converging
+		auto [G, dG, small_, iters_, m_] = Hypergeometric<X, 1, 0>({ X(-0.5) }, {}).value(-20);
+		assert(m_ == method::wynn);
+		assert(small_ == 0);
+		assert(iters_ == 100);
+		// terminating
+		assert(pow1p<X>(2, 3) == 27);
+	}
+
+	return 0;
+}
+int test_hypergeometric_method_d = test_hypergeometric_method<double>();
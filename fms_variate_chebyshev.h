@@ -0,0 +1,168 @@
+// fms_variate_chebyshev.h - piecewise Chebyshev approximation of variate functions
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numbers>
+#include <ostream>
+#include <vector>
+#include "fms_ensure.h"
+
+namespace fms::variate {
+
+	static inline const char chebyshev_doc[] = R"xyzyx(
+Piecewise Chebyshev interpolation of \(f\) on \([lo, hi]\) split into equal pieces.
+Each piece is interpolated at the Chebyshev points of the first kind and evaluated
+with the Clenshaw recurrence. The number of pieces is doubled until the maximum absolute
+error on a check grid of points between the nodes is at most the tolerance.
+Arguments outside \([lo, hi]\) are clamped to the interval.
+Chebyshev interpolation is within a small factor of the minimax polynomial of the same degree.
+)xyzyx";
+	template<class X = double>
+	class chebyshev {
+		X lo, hi;
+		size_t m; // number of pieces
+		unsigned n; // coefficients per piece
+		X m_h; // pieces per unit length
+		std::vector<X> c; // c[i * n + k] coefficient k of piece i
+
+		template<class F>
+		void fit(const F& f)
+		{
+			c.resize(m * n);
+			std::vector<X> fx(n);
+			X h = (hi - lo) / m;
+			for (size_t i = 0; i < m; ++i) {
+				for (unsigned j = 0; j < n; ++j) {
+					X t = cos(std::numbers::pi_v<X> * (j + X(0.5)) / n);
+					fx[j] = f(lo + (i + (t + 1) / 2) * h);
+				}
+				for (unsigned k = 0; k < n; ++k) {
+					X ck = 0;
+					for (unsigned j = 0; j < n; ++j) {
+						ck += fx[j] * cos(std::numbers::pi_v<X> * k * (j + X(0.5)) / n);
+					}
+					c[i * n + k] = (k ? 2 : 1) * ck / n;
+				}
+			}
+		}
+	public:
+		X error; // maximum error on the check grid
+
+		template<class F>
+		chebyshev(const F& f, X lo, X hi, X tol, unsigned degree = 16, size_t max_pieces = 1 << 12, unsigned check = 4)
+			: lo(lo), hi(hi), m(1), n(degree + 1)
+		{
+			ensure(lo < hi);
+			ensure(tol > 0);
+
+			for (;; m *= 2) {
+				ensure(m <= max_pieces);
+
+				m_h = m / (hi - lo);
+				fit(f);
+
+				error = 0;
+				size_t M = check * n * m;
+				for (size_t i = 0; i <= M; ++i) {
+					X x = lo + (hi - lo) * (i + X(0.5) * (i < M)) / M;
+					error = std::max(error, fabs((*this)(x) - f(x)));
+				}
+				if (error <= tol) {
+					break;
+				}
+			}
+		}
+
+		size_t pieces() const
+		{
+			return m;
+		}
+		unsigned degree() const
+		{
+			return n - 1;
+		}
+
+		X operator()(X x) const
+		{
+			x = std::clamp(x, lo, hi);
+			X u = (x - lo) * m_h;
+			size_t i = std::min(static_cast<size_t>(u), m - 1);
+			X t = 2 * (u - i) - 1;
+
+			// Clenshaw
+			const X* ci = c.data() + i * n;
+			X b1 = 0, b2 = 0;
+			for (unsigned k = n - 1; k > 0; --k) {
+				X b0 = 2 * t * b1 - b2 + ci[k];
+				b2 = b1;
+				b1 = b0;
+			}
+
+			return t * b1 - b2 + ci[0];
+		}
+
+		// Write a header defining constexpr X name(X x) with the coefficients of this approximation.
+		void header(std::ostream& os, const char* name, const char* type = "double") const
+		{
+			os << "// " << name << " - generated by fms::variate::chebyshev\n"
+			   << "// pieces: " << m << ", degree: " << n - 1 << ", error: " << error << "\n"
+			   << "#pragma once\n\n"
+			   << "inline constexpr " << type << " " << name << "_c[" << m << "][" << n << "] = {\n"
+			   << std::setprecision(std::numeric_limits<X>::max_digits10);
+			for (size_t i = 0; i < m; ++i) {
+				os << "\t{ ";
+				for (unsigned k = 0; k < n; ++k) {
+					os << c[i * n + k] << (k + 1 < n ? ", " : " ");
+				}
+				os << "},\n";
+			}
+			os << "};\n\n"
+			   << "constexpr " << type << " " << name << "(" << type << " x)\n"
+			   << "{\n"
+			   << "\tx = x < " << lo << " ? " << lo << " : x > " << hi << " ? " << hi << " : x;\n"
+			   << "\t" << type << " u = (x - " << lo << ") * " << m_h << ";\n"
+			   << "\tunsigned i = u < " << m - 1 << " ? static_cast<unsigned>(u) : " << m - 1 << ";\n"
+			   << "\t" << type << " t = 2 * (u - i) - 1;\n"
+			   << "\tconst " << type << "* c = " << name << "_c[i];\n"
+			   << "\t" << type << " b1 = 0, b2 = 0;\n"
+			   << "\tfor (unsigned k = " << n - 1 << "; k > 0; --k) {\n"
+			   << "\t\t" << type << " b0 = 2 * t * b1 - b2 + c[k];\n"
+			   << "\t\tb2 = b1;\n"
+			   << "\t\tb1 = b0;\n"
+			   << "\t}\n\n"
+			   << "\treturn t * b1 - b2 + c[0];\n"
+			   << "}\n";
+		}
+	};
+
+	// Approximate x -> v.cdf(x, s) on [lo, hi].
+	template<class V, class X = typename V::xtype, class S = typename V::stype>
+	inline chebyshev<X> cdf_chebyshev(const V& v, S s, X lo, X hi, X tol, unsigned degree = 16)
+	{
+		return chebyshev<X>([&v, s](X x) { return v.cdf(x, s); }, lo, hi, tol, degree);
+	}
+
+	// Approximate x -> v.pdf(x, s) on [lo, hi].
+	template<class V, class X = typename V::xtype, class S = typename V::stype>
+	inline chebyshev<X> pdf_chebyshev(const V& v, S s, X lo, X hi, X tol, unsigned degree = 16)
+	{
+		return chebyshev<X>([&v, s](X x) {
+			if constexpr (requires { v.pdf(x, s); }) {
+				return v.pdf(x, s);
+			}
+			else {
+				return v.cdf(x, s, 1);
+			}
+		}, lo, hi, tol, degree);
+	}
+
+	// Approximate s -> v.cgf(s) on [lo, hi].
+	template<class V, class S = typename V::stype>
+	inline chebyshev<S> cgf_chebyshev(const V& v, S lo, S hi, S tol, unsigned degree = 16)
+	{
+		return chebyshev<S>([&v](S s) { return v.cgf(s); }, lo, hi, tol, degree);
+	}
+
+}
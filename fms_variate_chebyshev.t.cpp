@@ -0,0 +1,44 @@
+// fms_variate_chebyshev.t.cpp - test piecewise Chebyshev approximation
+#include <cassert>
+#include <sstream>
+#include "fms_test.h"
+#include "fms_variate_normal.h"
+#include "fms_variate_chebyshev.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_chebyshev()
+{
+	{
+		chebyshev<X> p([](X x) { return 1 + x * (2 - x * x); }, -1, 2, 1e-14, 3);
+		assert(p.pieces() == 1);
+		assert(p.error <= 1e-14);
+		assert(fabs(p(0.5) - (1 + 0.5 * (2 - 0.25))) < 1e-14);
+		assert(p(3) == p(2)); // clamped
+	}
+	{
+		standard_normal<X> N;
+		X s = 0.25, tol = 1e-12;
+		auto F = cdf_chebyshev(N, s, X(-8), X(8), tol);
+		assert(F.error <= tol);
+		auto f = pdf_chebyshev(N, s, X(-8), X(8), tol);
+		assert(f.error <= tol);
+		auto K = cgf_chebyshev(N, X(-1), X(1), tol, 2);
+		assert(K.pieces() == 1);
+		for (X x : range<X>(-7.9, 7.9, 0.013)) {
+			assert(fabs(F(x) - N.cdf(x, s)) <= 2 * tol);
+			assert(fabs(f(x) - N.pdf(x, s)) <= 2 * tol);
+		}
+
+		std::ostringstream os;
+		F.header(os, "normal_cdf");
+		auto h = os.str();
+		assert(h.find("constexpr double normal_cdf(double x)") != std::string::npos);
+		assert(h.find("normal_cdf_c[" + std::to_string(F.pieces()) + "][17]") != std::string::npos);
+	}
+
+	return 0;
+}
+int test_chebyshev_d = test_chebyshev<double>();
@@ -0,0 +1,109 @@
+// fms_variate_fft.h - pdf and cdf grids from characteristic functions
+#pragma once
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <utility>
+#include <vector>
+#include "fms_ensure.h"
+
+namespace fms::variate {
+
+	// In place radix 2 transform z_j <- sum_k z_k exp(sign 2 pi i j k/N).
+	template<class X>
+	inline void fft(std::complex<X>* z, size_t N, int sign = -1)
+	{
+		ensure(N > 0 and (N & (N - 1)) == 0);
+
+		// bit reversal permutation
+		for (size_t i = 1, j = 0; i < N; ++i) {
+			size_t bit = N >> 1;
+			for (; j & bit; bit >>= 1) {
+				j ^= bit;
+			}
+			j ^= bit;
+			if (i < j) {
+				std::swap(z[i], z[j]);
+			}
+		}
+
+		for (size_t n = 2; n <= N; n <<= 1) {
+			X theta = sign * 2 * std::numbers::pi_v<X> / n;
+			std::complex<X> w_n = std::polar(X(1), theta);
+			for (size_t i = 0; i < N; i += n) {
+				std::complex<X> w = 1;
+				for (size_t k = 0; k < n / 2; ++k) {
+					std::complex<X> t = w * z[i + k + n / 2];
+					z[i + k + n / 2] = z[i + k] - t;
+					z[i + k] += t;
+					w *= w_n;
+				}
+			}
+		}
+	}
+
+	// Values at x0 + i dx, 0 <= i < N.
+	template<class X = double>
+	struct grid {
+		X x0, dx;
+		std::vector<X> pdf, cdf;
+
+		X x(size_t i) const
+		{
+			return x0 + i * dx;
+		}
+		size_t size() const
+		{
+			return pdf.size();
+		}
+	};
+
+	static inline const char cf_grid_doc[] = R"xyzyx(
+Invert a characteristic function \(\phi(u) = E[e^{iuX}]\) on the grid \(x_j = x_0 + j\Delta x\),
+\(0 \le j < N\), \(\Delta x = (x_1 - x_0)/N\).
+The density is approximated by the Fourier series \(f(x) \approx \sum_k \phi(u_k) e^{-iu_k x}/L\)
+with \(L = x_1 - x_0\), \(u_k = 2\pi k/L\), \(-N/2 \le k < N/2\), and the cdf by integrating term by term,
+\(F(x) \approx (x - x_0)/L + \sum_{k\ne 0} \phi(u_k)(e^{-iu_k x_0} - e^{-iu_k x})/(iu_k L)\).
+Both sums are computed with one FFT each. The distribution should have negligible mass
+outside \([x_0, x_1)\) and \(\phi\) should be negligible beyond \(u_{N/2}\).
+Sums of independent variates have characteristic function the product and mixtures the weighted sum.
+)xyzyx";
+	template<class X, class CF>
+	inline grid<X> cf_grid(const CF& cf, X x0, X x1, size_t N)
+	{
+		ensure(x0 < x1);
+
+		X L = x1 - x0;
+		X du = 2 * std::numbers::pi_v<X> / L;
+		std::vector<std::complex<X>> f(N), F(N);
+		std::complex<X> C = 0;
+
+		for (size_t k = 0; k < N; ++k) {
+			X u = (k < N / 2 ? X(k) : X(k) - X(N)) * du;
+			std::complex<X> phi = cf(u) * std::polar(1 / L, -u * x0);
+			f[k] = phi;
+			if (k != 0) {
+				F[k] = phi / std::complex<X>(0, u);
+				C += F[k];
+			}
+		}
+		fft(f.data(), N);
+		fft(F.data(), N);
+
+		grid<X> g{ x0, L / N, std::vector<X>(N), std::vector<X>(N) };
+		for (size_t j = 0; j < N; ++j) {
+			g.pdf[j] = f[j].real();
+			g.cdf[j] = X(j) / N + (C - F[j]).real();
+		}
+
+		return g;
+	}
+
+	// pdf and cdf of the share measure X_s on a grid using the cf member of the variate
+	template<class V, class X = typename V::xtype, class S = typename V::stype>
+	inline grid<X> cf_grid(const V& v, X x0, X x1, size_t N, S s)
+	{
+		return cf_grid<X>([&v, s](X u) { return v.cf(u, s); }, x0, x1, N);
+	}
+
+}
@@ -0,0 +1,77 @@
+// fms_variate_fft.t.cpp - test pdf and cdf grids from characteristic functions
+#include <cassert>
+#include <numbers>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_normal.h"
+#include "fms_variate_fft.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_fft()
+{
+	{
+		size_t N = 16;
+		std::vector<std::complex<X>> z(N), dft(N);
+		for (size_t k = 0; k < N; ++k) {
+			z[k] = std::complex<X>(X(k) / 3, X(1) / (k + 1));
+		}
+		for (size_t j = 0; j < N; ++j) {
+			for (size_t k = 0; k < N; ++k) {
+				dft[j] += z[k] * std::polar(X(1), -2 * std::numbers::pi_v<X> * j * k / N);
+			}
+		}
+		fft(z.data(), N);
+		for (size_t j = 0; j < N; ++j) {
+			assert(std::abs(z[j] - dft[j]) < 1e-12);
+		}
+		fft(z.data(), N, 1);
+		for (size_t k = 0; k < N; ++k) {
+			assert(std::abs(z[k] / X(N) - std::complex<X>(X(k) / 3, X(1) / (k + 1))) < 1e-12);
+		}
+	}
+
+	return 0;
+}
+int test_fft_d = test_fft<double>();
+
+template<class X>
+int test_cf_grid()
+{
+	standard_normal<X> N;
+	{
+		assert(N.cf(0) == X(1));
+		X s = 0.3;
+		auto g = cf_grid(N, X(-10), X(10), 256, s);
+		assert(g.size() == 256);
+		for (size_t j = 0; j < g.size(); ++j) {
+			X x = g.x(j);
+			assert(fabs(g.pdf[j] - N.pdf(x, s)) < 1e-12);
+			assert(fabs(g.cdf[j] - N.cdf(x, s)) < 1e-12);
+		}
+	}
+	{
+		// sum of independent standard normals is normal with variance 2
+		auto g = cf_grid<X>([&N](X u) { return N.cf(u) * N.cf(u); }, X(-16), X(16), 512);
+		constexpr X sqrt2 = std::numbers::sqrt2_v<X>;
+		for (size_t j = 0; j < g.size(); ++j) {
+			X x = g.x(j);
+			assert(fabs(g.pdf[j] - N.pdf(x / sqrt2, 0) / sqrt2) < 1e-12);
+			assert(fabs(g.cdf[j] - N.cdf(x / sqrt2, 0)) < 1e-12);
+		}
+	}
+	{
+		// mixture
+		X p = 0.25, s = -1;
+		auto g = cf_grid<X>([&N, p, s](X u) { return p * N.cf(u, s) + (1 - p) * N.cf(u); }, X(-12), X(12), 512);
+		for (size_t j = 0; j < g.size(); ++j) {
+			X x = g.x(j);
+			assert(fabs(g.cdf[j] - (p * N.cdf(x, s) + (1 - p) * N.cdf(x, 0))) < 1e-12);
+		}
+	}
+
+	return 0;
+}
+int test_cf_grid_d = test_cf_grid<double>();
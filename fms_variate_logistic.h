@@ -1,8 +1,11 @@
 // fms_variate_logistic
 #pragma once
+#include <complex>
 #include <concepts>
 #include <initializer_list>
+#include <vector>
 #include <gsl/gsl_math.h>
+#include <gsl/gsl_cdf.h>
 #include <gsl/gsl_sf_gamma.h>
 #include <gsl/gsl_sf_psi.h>
 #include <gsl/gsl_sf_hyperg.h>
@@ -39,6 +42,30 @@ namespace fms::variate {
 
 			return -(b + k) * A(a, b, n - 1, k) + (a + b + k - 1) * A(a, b, n - 1, k - 1);
 		}
+
+		// A_{n,k} for 0 <= k <= n < N stored by row at n(n + 1)/2 + k
+		template<class X = double>
+		inline std::vector<X> A_table(X a, X b, unsigned N)
+		{
+			std::vector<X> A_(N * (N + 1) / 2);
+
+			if (N > 0) {
+				A_[0] = 1;
+			}
+			for (unsigned n = 1; n < N; ++n) {
+				const X* A_1 = A_.data() + (n - 1) * n / 2; // previous row
+				X* A_n = A_.data() + n * (n + 1) / 2;
+				for (unsigned k = 0; k <= n; ++k) {
+					X Ak = k < n ? -(b + k) * A_1[k] : 0;
+					if (k > 0) {
+						Ak += (a + b + k - 1) * A_1[k - 1];
+					}
+					A_n[k] = Ak;
+				}
+			}
+
+			return A_;
+		}
 	}
 
 #ifdef _DEBUG
@@ -112,6 +139,25 @@ Where \(B(\alpha,\beta)\) is the beta function.
 
 			return cdf0(a + s, b - s, x, n);
 		}
+		// x with cdf(x, s) = p
+		X cdf_inv(X p, S s = 0) const
+		{
+			ensure(-a < s and s < b);
+
+			X a_ = a + s, b_ = b - s;
+			X u;
+			if (a_ == 1) {
+				u = -expm1(log1p(-p) / b_); // I_u(1, b) = 1 - (1 - u)^b
+			}
+			else if (b_ == 1) {
+				u = pow(p, 1 / a_); // I_u(a, 1) = u^a
+			}
+			else {
+				u = gsl_cdf_beta_Pinv(p, a_, b_);
+			}
+
+			return log(u / (1 - u));
+		}
 		S cgf(S s, unsigned n = 0) const
 		{
 			ensure(-1 < s and s < 1);
@@ -126,6 +172,18 @@ Where \(B(\alpha,\beta)\) is the beta function.
 			return gsl_sf_psi_n(n_, a + s) + ((n_&1) ? 1 : -1) * gsl_sf_psi_n(n_, b - s);
 		}
 
+		// E[exp(i u X_s)] = Gamma(a + s + i u) Gamma(b - s - i u)/(Gamma(a + s) Gamma(b - s))
+		std::complex<X> cf(X u, S s = 0) const
+		{
+			ensure(-a < s and s < b);
+
+			gsl_sf_result lna, arga, lnb, argb;
+			gsl_sf_lngamma_complex_e(a + s, u, &lna, &arga);
+			gsl_sf_lngamma_complex_e(b - s, -u, &lnb, &argb);
+
+			return std::polar(exp(lna.val + lnb.val - gsl_sf_lngamma(a + s) - gsl_sf_lngamma(b - s)), arga.val + argb.val);
+		}
+
 		// d/ds F_s(a,b;x) = d/ds F(a + s, b - s; x) = F_s(a + s, b - s; x) log u(1 - u)
 		X sdf(S s, X x) const
 		{
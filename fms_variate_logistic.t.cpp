@@ -1,7 +1,11 @@
 // fms_variate_logistic.t.cpp - test logistic variate
+#include <algorithm>
 #include <cassert>
+#include <span>
 #include "fms_test.h"
+#include "fms_variate_fft.h"
 #include "fms_variate_logistic.h"
+#include "fms_variate_stream.h"
 
 using namespace fms::test;
 using namespace fms::variate;
@@ -89,7 +93,71 @@ int test_variate_logistic()
 		}
 	}
 
+	{
+		logistic<X> v(1.5, 1.5);
+
+		X s = 0.2;
+		assert(std::abs(v.cf(0, s) - X(1)) < 1e-12);
+		auto g = cf_grid(v, X(-40), X(40), 2048, s);
+		for (size_t j = 0; j < g.size(); j += 7) {
+			X x = g.x(j);
+			assert(fabs(g.pdf[j] - v.cdf(x, s, 1)) < 1e-10);
+			assert(fabs(g.cdf[j] - v.cdf(x, s)) < 1e-10);
+		}
+	}
+	{
+		for (X a : { X(0.5), X(1), X(2) }) {
+			for (X b : { X(0.5), X(1), X(2) }) {
+				logistic<X> v(a, b);
+				for (X s : { X(0), X(0.3) }) {
+					for (X x : range<X>(-4, 4, 0.5)) {
+						X p = v.cdf(x, s);
+						assert(fabs(v.cdf_inv(p, s) - x) < 1e-8);
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+int test_variate_logistic_d = test_variate_logistic<double>();
+
+template<class X>
+int test_variate_logistic_expectation()
+{
+	logistic<X> v(2, 1.5);
+	X s = 0.1;
+	auto id = [](std::span<const X> x, X* y) { std::copy(x.begin(), x.end(), y); };
+	{
+		// E[X_s] = kappa'(s)
+		auto e = expectation(v, s, id, 100000, 2);
+		assert(fabs(e.value - v.cgf(s, 1)) < 4 * e.error);
+		auto e_ = expectation(v, s, id, 100000, 2, X(0.3));
+		assert(fabs(e_.value - v.cgf(s, 1)) < 4 * e_.error);
+		assert(e_.error < e.error);
+	}
+	{
+		// cgf not defined at s + t
+		bool thrown = false;
+		try {
+			expectation(v, s, id, 100, 1, X(0.95));
+		}
+		catch (const std::exception&) {
+			thrown = true;
+		}
+		assert(thrown);
+		// cgf not defined at s + 2t so the control variate variance is infinite
+		thrown = false;
+		try {
+			expectation(v, s, id, 100, 1, X(0.8));
+		}
+		catch (const std::exception&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
 
 	return 0;
 }
-int test_variate_logistic_d = test_variate_logistic<double>();
\ No newline at end of file
+int test_variate_logistic_expectation_d = test_variate_logistic_expectation<double>();
\ No newline at end of file
@@ -0,0 +1,187 @@
+// fms_variate_logistic_batch.h - structure of arrays of logistic variates
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <span>
+#include <vector>
+#include "fms_variate_logistic.h"
+
+namespace fms::variate {
+
+	// Allocator aligned to N bytes for vector loads.
+	template<class T, size_t N = 64>
+	struct aligned_allocator {
+		typedef T value_type;
+		template<class U> struct rebind {
+			typedef aligned_allocator<U, N> other;
+		};
+
+		aligned_allocator() noexcept
+		{ }
+		template<class U>
+		aligned_allocator(const aligned_allocator<U, N>&) noexcept
+		{ }
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(N)));
+		}
+		void deallocate(T* p, size_t) noexcept
+		{
+			::operator delete(p, std::align_val_t(N));
+		}
+
+		template<class U>
+		bool operator==(const aligned_allocator<U, N>&) const noexcept
+		{
+			return true;
+		}
+	};
+
+	static inline const char logistic_batch_doc[] = R"xyzyx(
+Logistic variates \((\alpha_i, \beta_i)\) stored as separate aligned arrays with
+\(\log\Gamma(\alpha_i)\), \(\log\Gamma(\beta_i)\), and \(\log\Gamma(\alpha_i + \beta_i)\) cached.
+The kernel evaluates cdf, pdf, cgf, and sdf of every variate at its own \((x_i, s_i)\)
+in blocks. The density uses \(\log B(\alpha + s, \beta - s) = \kappa(s) + \log B(\alpha, \beta)\)
+so the log gamma functions of the cumulant are shared.
+The kernel is bound by two scalar \(\log\Gamma\) calls per variate and, for cdf or sdf, one scalar
+incomplete beta function call. Only the arithmetic loops vectorize with default flags.
+The \(\exp\) and \(\log1p\) loops vectorize with gcc and glibc only under \(\texttt{-ffast-math}\),
+since glibc declares the libmvec variants only when \(\texttt{\_\_FAST\_MATH\_\_}\) is defined.
+)xyzyx";
+	template<class X = double, class S = X>
+		requires std::is_floating_point_v<X> && std::is_floating_point_v<S>
+	class logistic_batch {
+		template<class T> using array = std::vector<T, aligned_allocator<T>>;
+		static constexpr size_t block = 256; // temporaries stay in cache
+		array<X> a_, b_;
+		array<X> lga_, lgb_, lgab_; // log Gamma(a), log Gamma(b), log Gamma(a + b)
+	public:
+		typedef X xtype;
+		typedef S stype;
+
+		logistic_batch()
+		{ }
+		logistic_batch(size_t n)
+		{
+			reserve(n);
+		}
+
+		size_t size() const
+		{
+			return a_.size();
+		}
+		void reserve(size_t n)
+		{
+			for (auto* v : { &a_, &b_, &lga_, &lgb_, &lgab_ }) {
+				v->reserve(n);
+			}
+		}
+		void push_back(X a, X b)
+		{
+			ensure(a > 0 and b > 0);
+
+			a_.push_back(a);
+			b_.push_back(b);
+			lga_.push_back(gsl_sf_lngamma(a));
+			lgb_.push_back(gsl_sf_lngamma(b));
+			lgab_.push_back(gsl_sf_lngamma(a + b));
+		}
+		void push_back(const logistic<X, S>& v)
+		{
+			push_back(v.a, v.b);
+		}
+		logistic<X, S> operator[](size_t i) const
+		{
+			return logistic<X, S>(a_[i], b_[i]);
+		}
+
+		// read only parameters and cached log gamma values
+		std::span<const X> a() const
+		{
+			return a_;
+		}
+		std::span<const X> b() const
+		{
+			return b_;
+		}
+		std::span<const X> lga() const
+		{
+			return lga_;
+		}
+		std::span<const X> lgb() const
+		{
+			return lgb_;
+		}
+		std::span<const X> lgab() const
+		{
+			return lgab_;
+		}
+
+		// For each variate i compute any non null outputs at x[i] and s[i].
+		// cdf[i] = cdf(x[i], s[i]), pdf[i] = cdf(x[i], s[i], 1), cgf[i] = cgf(s[i]), sdf[i] = sdf(s[i], x[i])
+		void operator()(const X* x, const S* s, X* cdf, X* pdf = nullptr, S* cgf = nullptr, X* sdf = nullptr) const
+		{
+			alignas(64) S K[block], lB[block];
+			alignas(64) X u[block], l1p[block], F[block];
+
+			for (size_t i0 = 0; i0 < size(); i0 += block) {
+				size_t n = std::min(block, size() - i0);
+				const X* A = a_.data() + i0;
+				const X* B = b_.data() + i0;
+				const X* x_ = x + i0;
+				const S* s_ = s + i0;
+
+				for (size_t i = 0; i < n; ++i) {
+					ensure(-A[i] < s_[i] and s_[i] < B[i]);
+				}
+
+				// log gamma of shifted parameters
+				for (size_t i = 0; i < n; ++i) {
+					K[i] = gsl_sf_lngamma(A[i] + s_[i]) + gsl_sf_lngamma(B[i] - s_[i]);
+				}
+				for (size_t i = 0; i < n; ++i) {
+					lB[i] = K[i] - lgab_[i0 + i];
+					K[i] -= lga_[i0 + i] + lgb_[i0 + i];
+				}
+				if (cgf) {
+					for (size_t i = 0; i < n; ++i) {
+						cgf[i0 + i] = K[i];
+					}
+				}
+
+				for (size_t i = 0; i < n; ++i) {
+					X e_x = exp(-x_[i]);
+					u[i] = 1 / (1 + e_x);
+					l1p[i] = log1p(e_x);
+				}
+				if (pdf) {
+					for (size_t i = 0; i < n; ++i) {
+						pdf[i0 + i] = exp(-(B[i] - s_[i]) * x_[i] - (A[i] + B[i]) * l1p[i] - lB[i]);
+					}
+				}
+
+				if (cdf or sdf) {
+					for (size_t i = 0; i < n; ++i) {
+						F[i] = gsl_sf_beta_inc(A[i] + s_[i], B[i] - s_[i], u[i]);
+					}
+					if (cdf) {
+						for (size_t i = 0; i < n; ++i) {
+							cdf[i0 + i] = F[i];
+						}
+					}
+					if (sdf) {
+						// log u(1 - u) = -x - 2 log(1 + e^{-x})
+						for (size_t i = 0; i < n; ++i) {
+							sdf[i0 + i] = (-x_[i] - 2 * l1p[i]) * F[i];
+						}
+					}
+				}
+			}
+		}
+	};
+
+}
@@ -0,0 +1,49 @@
+// fms_variate_logistic_batch.t.cpp - test structure of arrays of logistic variates
+#include <cassert>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_logistic_batch.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_variate_logistic_batch()
+{
+	{
+		aligned_allocator<X> alloc;
+		X* p = alloc.allocate(3);
+		assert(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+		alloc.deallocate(p, 3);
+	}
+	{
+		logistic_batch<X> batch;
+		std::vector<X> x, s;
+		size_t n = 600; // more than one block
+		for (size_t i = 0; i < n; ++i) {
+			batch.push_back(X(0.5) + (i % 7) * X(0.3), X(0.6) + (i % 5) * X(0.4));
+			x.push_back(-5 + X(10) * i / n);
+			s.push_back(X(-0.4) + (i % 9) * X(0.1));
+		}
+		assert(batch.size() == n);
+		assert(batch.a().size() == n and batch.a()[8] == X(0.8));
+		assert(batch.lgab()[3] == gsl_sf_lngamma(batch.a()[3] + batch.b()[3]));
+
+		std::vector<X> F(n), f(n), K(n), D(n);
+		batch(x.data(), s.data(), F.data(), f.data(), K.data(), D.data());
+		for (size_t i = 0; i < n; ++i) {
+			auto v = batch[i];
+			assert(fabs(F[i] - v.cdf(x[i], s[i])) <= 1e-14);
+			assert(fabs(f[i] - v.cdf(x[i], s[i], 1)) <= 1e-12 * std::max(X(1), f[i]));
+			assert(fabs(K[i] - v.cgf(s[i])) <= 1e-13);
+			assert(fabs(D[i] - v.sdf(s[i], x[i])) <= 1e-12);
+		}
+
+		std::vector<X> G(n);
+		batch(x.data(), s.data(), G.data());
+		assert(G == F);
+	}
+
+	return 0;
+}
+int test_variate_logistic_batch_d = test_variate_logistic_batch<double>();
@@ -0,0 +1,320 @@
+// fms_variate_logistic_cache.h - shared cache of prepared logistic variates
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "fms_variate_logistic.h"
+
+namespace fms::variate {
+
+	// Logistic variate at fixed (a, b, s) with everything not depending on x computed once.
+	template<class X = double, class S = X>
+		requires std::is_floating_point_v<X> && std::is_floating_point_v<S>
+	class logistic_prepared {
+		std::vector<X> A_; // A_{n,k} of a + s, b - s
+		std::vector<X> F, dF; // cdf and pdf at x0 + i dx
+	public:
+		typedef X xtype;
+		typedef S stype;
+		const X a, b;
+		const S s;
+		const S kappa; // cgf(s)
+		const X beta; // B(a + s, b - s)
+		const unsigned N; // cdf derivatives available to cdf(x, n)
+		const X x0, dx; // cdf table grid
+
+		logistic_prepared(X a, X b, S s, unsigned N = 8, X x0 = -16, X x1 = 16, size_t M = 1025)
+			: A_(A_table(a + s, b - s, N)),
+			  a(a), b(b), s(s),
+			  kappa(logistic<X, S>(a, b).cgf(s)),
+			  beta(gsl_sf_beta(a + s, b - s)),
+			  N(N), x0(x0), dx((x1 - x0) / (M - 1))
+		{
+			ensure(a > 0 and b > 0);
+			ensure(-a < s and s < b);
+			ensure(x0 < x1 and M > 1);
+
+			F.resize(M);
+			dF.resize(M);
+			for (size_t i = 0; i < M; ++i) {
+				X x = x0 + i * dx;
+				F[i] = cdf(x, 0);
+				dF[i] = cdf(x, 1);
+			}
+		}
+		logistic_prepared(const logistic_prepared&) = delete;
+		logistic_prepared& operator=(const logistic_prepared&) = delete;
+		~logistic_prepared()
+		{ }
+
+		// Row n of A_{n,k} for a + s, b - s.
+		const X* A(unsigned n) const
+		{
+			ensure(n < N);
+
+			return A_.data() + n * (n + 1) / 2;
+		}
+
+		// (d/dx)^n P_s(X <= x) using the precomputed beta and A_{n,k}.
+		X cdf(X x, unsigned n = 0) const
+		{
+			X e_x = exp(-x);
+
+			if (n == 0) {
+				return gsl_sf_beta_inc(a + s, b - s, 1 / (1 + e_x));
+			}
+
+			const X* An = A(n - 1);
+			X e_ = e_x / (1 + e_x);
+			X Ak = 0;
+			for (unsigned k = n; k-- > 0; ) {
+				Ak = Ak * e_ + An[k];
+			}
+
+			return exp(-(b - s) * x) * pow(1 + e_x, -a - b) * Ak / beta;
+		}
+
+		// cdf from cubic Hermite interpolation of the table, exact outside the table
+		X cdf_table(X x) const
+		{
+			X t = (x - x0) / dx;
+			if (!(t >= 0 and t < F.size() - 1)) {
+				return cdf(x, 0);
+			}
+
+			size_t i = static_cast<size_t>(t);
+			t -= i;
+			X t2 = t * t, t3 = t2 * t;
+
+			return (2 * t3 - 3 * t2 + 1) * F[i] + (t3 - 2 * t2 + t) * dx * dF[i]
+			     + (-2 * t3 + 3 * t2) * F[i + 1] + (t3 - t2) * dx * dF[i + 1];
+		}
+
+		// d/ds cdf, see logistic::sdf
+		X sdf(X x) const
+		{
+			X u = 1 / (1 + exp(-x));
+
+			return log(u * (1 - u)) * cdf(x, 0);
+		}
+	};
+
+	static inline const char logistic_cache_doc[] = R"xyzyx(
+Prepared logistic variates shared between threads. Parameters are rounded to a multiple
+of the tolerance and the prepared variate is built at the rounded values, so every thread
+gets the same object for \((\alpha, \beta, s)\) within the tolerance.
+Entries live in an immutable snapshot that writers replace under a mutex and publish by
+incrementing a version counter. Each thread keeps its own reference to the last snapshot it
+used, so a lookup that hits costs an acquire load of the version, a hash lookup, and a
+timestamp store at most once per microsecond. Only threads that see a new version load the
+shared snapshot pointer, which takes a short internal lock in common standard libraries.
+A thread keeps its snapshot alive until its next call on a cache of the same type or until it
+exits. operator() returns a reference that is valid until the calling thread's next call on a
+cache of the same type and get() returns a shared pointer that can be held indefinitely.
+Hit counts are kept in per thread shards. The least recently used entry is evicted when
+capacity is exceeded.
+)xyzyx";
+	template<class X = double, class S = X>
+	class logistic_cache {
+	public:
+		using prepared = logistic_prepared<X, S>;
+		struct statistics {
+			uint64_t hits, misses, evictions;
+			size_t size;
+		};
+	private:
+		struct key {
+			int64_t a, b, s;
+			bool operator==(const key&) const = default;
+		};
+		struct hash {
+			size_t operator()(const key& k) const
+			{
+				uint64_t h = 0xcbf29ce484222325ull;
+				for (int64_t i : { k.a, k.b, k.s }) {
+					h = (h ^ static_cast<uint64_t>(i)) * 0x100000001b3ull;
+				}
+
+				return static_cast<size_t>(h);
+			}
+		};
+		struct entry {
+			std::shared_ptr<const prepared> p;
+			mutable std::atomic<uint64_t> used; // time of last lookup in nanoseconds
+
+			entry(std::shared_ptr<const prepared> p, uint64_t time)
+				: p(std::move(p)), used(time)
+			{ }
+		};
+		using snapshot = std::unordered_map<key, std::shared_ptr<entry>, hash>;
+		// snapshot last used by this thread
+		struct local {
+			uint64_t id = 0, version = 0;
+			std::shared_ptr<const snapshot> snap;
+		};
+
+		std::atomic<std::shared_ptr<const snapshot>> table;
+		std::atomic<uint64_t> version; // incremented when table is replaced
+		std::mutex insert; // serialize writers
+		static constexpr size_t shards = 16;
+		struct alignas(64) counter {
+			std::atomic<uint64_t> n = 0;
+		};
+		counter hits[shards]; // indexed by thread
+		std::atomic<uint64_t> misses, evictions;
+		const uint64_t id; // distinguishes caches in thread local state
+		size_t capacity;
+		X tol;
+		unsigned N; // derivatives in prepared variates
+
+		static uint64_t next_id()
+		{
+			static std::atomic<uint64_t> n = 0;
+
+			return ++n;
+		}
+		static local& cached()
+		{
+			static thread_local local l;
+
+			return l;
+		}
+		key quantize(X a, X b, S s) const
+		{
+			constexpr X max = X(0x1p62); // llround is exact and does not overflow
+			ensure(fabs(a / tol) < max and fabs(b / tol) < max and fabs(s / tol) < max);
+
+			return key{ std::llround(a / tol), std::llround(b / tol), std::llround(s / tol) };
+		}
+		static size_t shard()
+		{
+			static thread_local size_t i = std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards;
+
+			return i;
+		}
+		static uint64_t now()
+		{
+			using namespace std::chrono;
+
+			return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+		}
+		// this thread's snapshot, reloaded if the table was replaced
+		const snapshot& current()
+		{
+			local& l = cached();
+			uint64_t v = version.load(std::memory_order_acquire);
+			if (l.id != id or l.version != v) {
+				l.snap = table.load(std::memory_order_acquire);
+				l.id = id;
+				l.version = v;
+			}
+
+			return *l.snap;
+		}
+
+		const entry& lookup(X a, X b, S s)
+		{
+			key k = quantize(a, b, s);
+
+			{
+				const snapshot& snap = current();
+				auto i = snap.find(k);
+				if (i != snap.end()) {
+					const entry& e = *i->second;
+					uint64_t t = now();
+					if (t > e.used.load(std::memory_order_relaxed) + 1000) { // avoid writing a shared line on every hit
+						e.used.store(t, std::memory_order_relaxed);
+					}
+					hits[shard()].n.fetch_add(1, std::memory_order_relaxed);
+
+					return e;
+				}
+			}
+
+			misses.fetch_add(1, std::memory_order_relaxed);
+			// build outside the lock
+			auto p = std::make_shared<const prepared>(k.a * tol, k.b * tol, k.s * tol, N);
+
+			std::lock_guard lock(insert);
+			local& l = cached();
+			l.snap = table.load(std::memory_order_acquire);
+			l.id = id;
+			l.version = version.load(std::memory_order_relaxed);
+			auto i = l.snap->find(k);
+			if (i != l.snap->end()) { // another thread won the race
+				return *i->second;
+			}
+
+			auto next = std::make_shared<snapshot>(*l.snap);
+			while (next->size() >= capacity) {
+				auto lru = next->begin();
+				for (auto j = next->begin(); j != next->end(); ++j) {
+					if (j->second->used.load(std::memory_order_relaxed) < lru->second->used.load(std::memory_order_relaxed)) {
+						lru = j;
+					}
+				}
+				next->erase(lru);
+				evictions.fetch_add(1, std::memory_order_relaxed);
+			}
+			auto e = std::make_shared<entry>(std::move(p), now());
+			next->emplace(k, e);
+			l.snap = next;
+			table.store(std::move(next), std::memory_order_release);
+			l.version = version.fetch_add(1, std::memory_order_release) + 1;
+
+			return *e;
+		}
+	public:
+		logistic_cache(size_t capacity = 64, X tol = X(1e-12), unsigned N = 8)
+			: table(std::make_shared<const snapshot>()), version(0), misses(0), evictions(0), id(next_id()),
+			  capacity(capacity), tol(tol), N(N)
+		{
+			ensure(capacity > 0 and tol > 0);
+		}
+		logistic_cache(const logistic_cache&) = delete;
+		logistic_cache& operator=(const logistic_cache&) = delete;
+		~logistic_cache()
+		{ }
+
+		// Prepared variate for (a, b, s) rounded to tol, valid until this thread calls a cache of this type again.
+		const prepared& operator()(X a, X b, S s)
+		{
+			return *lookup(a, b, s).p;
+		}
+
+		// Prepared variate for (a, b, s) rounded to tol.
+		std::shared_ptr<const prepared> get(X a, X b, S s)
+		{
+			return lookup(a, b, s).p;
+		}
+
+		statistics stats() const
+		{
+			uint64_t hit = 0;
+			for (const auto& h : hits) {
+				hit += h.n.load(std::memory_order_relaxed);
+			}
+
+			return statistics{
+				hit,
+				misses.load(std::memory_order_relaxed),
+				evictions.load(std::memory_order_relaxed),
+				table.load(std::memory_order_acquire)->size()
+			};
+		}
+
+		void clear()
+		{
+			std::lock_guard lock(insert);
+			table.store(std::make_shared<const snapshot>(), std::memory_order_release);
+			version.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+}
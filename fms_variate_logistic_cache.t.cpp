@@ -0,0 +1,114 @@
+// fms_variate_logistic_cache.t.cpp - test shared cache of prepared logistic variates
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_logistic_cache.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_variate_logistic_prepared()
+{
+	{
+		for (X a : { X(0.9), X(1), X(1.1) }) {
+			for (X b : { X(0.9), X(1), X(1.1) }) {
+				for (unsigned n = 0; n < 5; ++n) {
+					auto A_ = A_table(a, b, n + 1);
+					for (unsigned k = 0; k <= n; ++k) {
+						X Ank = A(a, b, n, k);
+						assert(fabs(A_[n * (n + 1) / 2 + k] - Ank) <= 1e-12 * std::max(X(1), fabs(Ank)));
+					}
+				}
+			}
+		}
+	}
+	{
+		X a = 1.5, b = 0.5, s = 0.2;
+		logistic<X> v(a, b);
+		logistic_prepared<X> p(a, b, s);
+
+		assert(p.kappa == v.cgf(s));
+		for (X x : range<X>(-4, 4, 0.5)) {
+			for (unsigned n = 0; n < 4; ++n) {
+				X F = v.cdf(x, s, n);
+				assert(fabs(p.cdf(x, n) - F) <= 1e-12 * std::max(X(1), fabs(F)));
+			}
+			assert(fabs(p.cdf_table(x + X(0.01)) - p.cdf(x + X(0.01))) < 1e-8);
+			assert(p.sdf(x) == v.sdf(s, x));
+		}
+		assert(p.cdf_table(-20) == p.cdf(-20));
+		assert(p.cdf_table(20) == p.cdf(20));
+	}
+
+	return 0;
+}
+int test_variate_logistic_prepared_d = test_variate_logistic_prepared<double>();
+
+template<class X>
+int test_variate_logistic_cache()
+{
+	{
+		logistic_cache<X> cache(2, X(1e-6));
+
+		auto p = cache.get(1, 1, 0.1);
+		assert(cache.stats().misses == 1);
+		assert(cache.get(1, 1, 0.1) == p);
+		assert(cache.get(1 + X(1e-8), 1, 0.1) == p);
+		assert(cache.stats().hits == 2);
+
+		auto q = cache.get(1, 2, 0.1);
+		assert(q != p);
+		cache.get(1, 1, 0.1); // q is now least recently used
+		cache.get(2, 2, 0.1);
+		auto st = cache.stats();
+		assert(st.evictions == 1);
+		assert(st.size == 2);
+		assert(cache.get(1, 1, 0.1) == p);
+		assert(cache.get(1, 2, 0.1) != q); // rebuilt
+		assert(q->cdf(0) == cache.get(1, 2, 0.1)->cdf(0));
+
+		// reference into this thread's snapshot
+		const auto& r = cache(1, 1, 0.1);
+		assert(&r == p.get());
+		assert(r.cdf(0.5) == p->cdf(0.5));
+
+		cache.clear();
+		assert(cache.stats().size == 0);
+		assert(&cache(1, 1, 0.1) != p.get());
+
+		// parameters too large to quantize
+		bool thrown = false;
+		try {
+			cache.get(1e13, 1, 0.1);
+		}
+		catch (const std::exception&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+	{
+		logistic_cache<X> cache(8);
+		std::vector<std::thread> ts;
+		for (int t = 0; t < 4; ++t) {
+			ts.emplace_back([&cache]() {
+				for (int i = 0; i < 100; ++i) {
+					const auto& p = cache(1, 1 + (i % 4) * X(0.5), X(0.1));
+					assert(fabs(p.b - (1 + (i % 4) * X(0.5))) < 1e-9);
+				}
+			});
+		}
+		for (auto& t : ts) {
+			t.join();
+		}
+		auto st = cache.stats();
+		assert(st.hits + st.misses == 400);
+		assert(st.size == 4);
+		assert(st.evictions == 0);
+	}
+
+	return 0;
+}
+int test_variate_logistic_cache_d = test_variate_logistic_cache<double>();
@@ -0,0 +1,338 @@
+// fms_variate_logistic_sweep.h - logistic values along sorted grids
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "fms_variate_logistic.h"
+
+namespace fms::variate {
+
+	static inline const char cdf_sweep_doc[] = R"xyzyx(
+Evaluate the logistic share cdf \(F(x) = I_{u}(\alpha + s, \beta - s)\), \(u = 1/(1 + e^{-x})\),
+at increasing \(x_0 \le x_1 \le \cdots\).
+At an anchor \(x_a\) the derivatives \(F^{(m)}(x_a)\), \(1 \le m \le\) order, are computed from the
+closed form \(f(x)\sum_k A_{m-1,k}(1 + e^x)^{-k}\) and points within the step of the anchor
+use the Taylor polynomial. The step is the smaller of radius and the \(h\) with
+\(|F^{(\text{order})}(x_a)|h^{\text{order}}/\text{order}! \le \text{tol}\), so it shrinks as the
+derivatives grow with \(\alpha + \beta\). Anchors advance by the step using the Taylor polynomial
+and are recomputed with the incomplete beta function every reanchor steps, across large gaps,
+and for points before the anchor. Each call ends at an exact anchor.
+At each exact anchor the drift of the Taylor value is compared to tol. If it is larger then
+reanchor is halved and the points since the previous exact anchor are evaluated again, so
+values are only returned from spans whose drift is at most tol or that have no Taylor steps.
+The largest drift seen is kept in drift. It measures the error at the ends of spans only.
+Inside a step the error also includes rounding in the derivatives, since the \(A_{m,k}\) grow
+with \(\alpha + \beta\) and their sum cancels. With the default arguments the measured absolute
+error is below \(2\cdot 10^{-14}\) for \(\alpha + \beta \le 5\) and below \(2\cdot 10^{-13}\) for
+\(\alpha + \beta \le 100\) and \(|s| \le 0.3\).
+)xyzyx";
+	template<class X = double, class S = X>
+	class cdf_sweep {
+		X a, b; // a + s, b - s
+		X lbeta; // log B(a, b)
+		unsigned order;
+		X radius;
+		unsigned reanchor, reanchor0;
+		X tol;
+		X step; // Taylor step at current anchor
+		std::vector<X> A_; // A_{n,k} of a, b
+		std::vector<X> d; // F^{(m)}(x_a)/m!
+		X x_a; // current anchor
+		unsigned steps; // Taylor steps since last exact anchor
+		std::vector<X> d_e; // d at last exact anchor
+		X x_e, step_e; // last exact anchor and its step
+
+		// check arguments before any special functions are called
+		static X shifted(const logistic<X, S>& v, S s, unsigned order, X radius, unsigned reanchor, X tol)
+		{
+			ensure(-v.a < s and s < v.b);
+			ensure(order > 0 and radius > 0 and reanchor > 0 and tol > 0);
+
+			return v.a + s;
+		}
+
+		// d[m] = F^{(m)}(x)/m! given d[0] = F(x)
+		void anchor(X x, X F)
+		{
+			X f = exp(-b * x - (a + b) * log1p(exp(-x)) - lbeta);
+			X e_ = 1 / (1 + exp(x)); // e^{-x}/(1 + e^{-x})
+			X m_ = 1; // m!
+
+			x_a = x;
+			d[0] = F;
+			for (unsigned m = 1; m <= order; ++m) {
+				const X* Am = A_.data() + (m - 1) * m / 2;
+				X Ak = 0;
+				for (unsigned k = m; k-- > 0; ) {
+					Ak = Ak * e_ + Am[k];
+				}
+				m_ *= m;
+				d[m] = f * Ak / m_;
+			}
+
+			// last terms bound the truncation error, several in case one is near a zero
+			step = radius;
+			for (unsigned m = order > 3 ? order - 3 : 1; m <= order; ++m) {
+				if (d[m] != 0) {
+					step = std::min(step, pow(tol / fabs(d[m]), X(1) / m));
+				}
+			}
+		}
+		// anchor at x using the incomplete beta function and save the state
+		void exact_anchor(X x, X F)
+		{
+			anchor(x, F);
+			steps = 0;
+			d_e = d;
+			x_e = x_a;
+			step_e = step;
+		}
+		// Exact anchor at x with Taylor value F_. Returns false and goes back to
+		// the last exact anchor with a smaller reanchor if the drift is too large.
+		bool check_anchor(X x, X F_)
+		{
+			X F = exact(x);
+			X e = fabs(F - F_);
+			if (e > tol and reanchor > 1) {
+				reanchor /= 2;
+				d = d_e;
+				x_a = x_e;
+				step = step_e;
+				steps = 0;
+
+				return false;
+			}
+			drift = std::max(drift, e);
+			exact_anchor(x, F);
+
+			return true;
+		}
+		X taylor(X h) const
+		{
+			X F = 0;
+			for (unsigned m = order + 1; m-- > 0; ) {
+				F = F * h + d[m];
+			}
+
+			return F;
+		}
+		X exact(X x) const
+		{
+			return gsl_sf_beta_inc(a, b, 1 / (1 + exp(-x)));
+		}
+	public:
+		X drift; // largest difference between Taylor and exact values at exact anchors
+
+		cdf_sweep(const logistic<X, S>& v, S s = 0, unsigned order = 16, X radius = X(0.25), unsigned reanchor = 16,
+			X tol = X(1e-14))
+			: a(shifted(v, s, order, radius, reanchor, tol)), b(v.b - s), lbeta(gsl_sf_lnbeta(a, b)),
+			  order(order), radius(radius), reanchor(reanchor), reanchor0(reanchor),
+			  tol(tol), step(0), A_(A_table(a, b, order)), d(order + 1), x_a(std::numeric_limits<X>::quiet_NaN()),
+			  steps(0), x_e(x_a), step_e(0), drift(0)
+		{ }
+
+		// F[i] = v.cdf(x[i], s) for nondecreasing x[i], 0 <= i < n
+		void operator()(const X* x, X* F, size_t n)
+		{
+			size_t i = 0, i_e = 0; // i_e is the first point evaluated since the last exact anchor
+			while (i < n) {
+				ensure(i == 0 or x[i - 1] <= x[i]);
+
+				X h = x[i] - x_a;
+				if (!(0 <= h and h <= reanchor * step)) { // also first point
+					exact_anchor(x[i], exact(x[i]));
+					i_e = i;
+					h = 0;
+				}
+				bool redo = false;
+				while (h > step) {
+					X x_ = x_a + step;
+					X F_ = taylor(step);
+					if (++steps < reanchor) {
+						anchor(x_, F_);
+					}
+					else if (!check_anchor(x_, F_)) {
+						redo = true;
+						break;
+					}
+					else {
+						i_e = i;
+					}
+					h = x[i] - x_a;
+				}
+				if (redo) {
+					i = i_e;
+					continue;
+				}
+				F[i] = taylor(h);
+				++i;
+
+				// end the call at an exact anchor so returned values are checked
+				if (i == n and steps > 0) {
+					if (check_anchor(x_a, d[0])) {
+						i_e = n;
+					}
+					else {
+						i = i_e;
+					}
+				}
+			}
+		}
+
+		// start a new sweep
+		void reset()
+		{
+			x_a = std::numeric_limits<X>::quiet_NaN();
+			steps = 0;
+			reanchor = reanchor0;
+			drift = 0;
+		}
+	};
+
+	static inline const char cgf_sweep_doc[] = R"xyzyx(
+Evaluate the logistic cumulant \(\kappa(s)\) and its derivatives \(\kappa^{(n)}(s)\), \(0 \le n < N\), along a ladder of \(s\).
+At an anchor \(s_a\) the derivatives \(\kappa^{(j)}(s_a)\), \(0 \le j \le N + p\), are computed with
+log gamma and polygamma functions and nearby \(s\) use the Taylor polynomials
+\(\kappa^{(n)}(s_a + h) = \sum_{j \le p} \kappa^{(n + j)}(s_a)h^j/j!\).
+The next term of the series determines the largest \(h\) with relative error less than tol.
+An anchor costs \(p + 1\) more cumulant evaluations than evaluating \(s_a\) directly. The cumulant
+is analytic in the disk of radius \(\rho = \min(\alpha + s, \beta - s)\) so the reach of order \(p\)
+is about \(\rho\,(\text{tol}/\binom{N + p}{N - 1})^{1/(p + 1)}\). Before anchoring, the order
+\(p \le\) order that saves the most evaluations on the following points of the ladder is chosen,
+and \(s\) is evaluated directly if no order saves any. Short ladders and ladders near the poles
+\(-\alpha\) and \(\beta\) cost no more than direct evaluation.
+The share vega \(\log u(1 - u) I_u(\alpha + s, \beta - s)\) is not swept. Only \(\log u(1 - u)\) is
+shared and each \(s\) needs one incomplete beta function evaluation.
+)xyzyx";
+	template<class X = double, class S = X>
+	class cgf_sweep {
+		logistic<X, S> v;
+		unsigned N, max_order, order; // order of current anchor
+		S tol;
+		std::vector<S> c; // kappa^{(j)}(s_a)/j!
+		S s_a, h_a; // anchor and reach
+
+		static S binomial(unsigned n, unsigned k)
+		{
+			S C = 1;
+			for (unsigned i = 1; i <= k; ++i) {
+				C = C * (n - k + i) / i;
+			}
+
+			return C;
+		}
+		S cgf(S s, unsigned n)
+		{
+			++evaluations;
+
+			return v.cgf(s, n);
+		}
+
+		// Order of an anchor at s[i] saving the most evaluations on s[i + 1], ..., or 0 if none saves any.
+		unsigned plan(const S* s, size_t i, size_t m) const
+		{
+			S rho = std::min(v.a + s[i], v.b - s[i]);
+			unsigned p_ = 0;
+			long best = 0; // evaluations saved
+
+			for (unsigned p = 1; p <= max_order; ++p) {
+				S h = rho * pow(tol / binomial(N + p, N - 1), S(1) / (p + 1));
+				size_t k = i + 1;
+				while (k < m and fabs(s[k] - s[i]) <= h) {
+					++k;
+				}
+				long saved = static_cast<long>((k - i - 1) * N) - static_cast<long>(p + 1);
+				if (saved > best) {
+					best = saved;
+					p_ = p;
+				}
+			}
+
+			return p_;
+		}
+		void anchor(S s, unsigned p)
+		{
+			order = p;
+			S j_ = 1; // j!
+			c[0] = cgf(s, 0);
+			for (unsigned j = 1; j <= N + order; ++j) {
+				j_ *= j;
+				c[j] = cgf(s, j) / j_;
+			}
+			s_a = s;
+
+			// |c[n + order + 1]| h^{order + 1} binomial(n + order + 1, n) < tol |c[n]|
+			h_a = std::numeric_limits<S>::infinity();
+			for (unsigned n = 0; n < N; ++n) {
+				S e = fabs(c[n + order + 1]) * binomial(n + order + 1, n);
+				if (e != 0) {
+					S h = pow(tol * std::max(S(1), fabs(c[n])) / e, S(1) / (order + 1));
+					h_a = std::min(h_a, h);
+				}
+			}
+		}
+	public:
+		size_t evaluations; // calls to logistic::cgf
+
+		cgf_sweep(const logistic<X, S>& v, unsigned N = 4, unsigned order = 16, S tol = S(1e-13))
+			: v(v), N(N), max_order(order), order(0), tol(tol), c(N + order + 1),
+			  s_a(std::numeric_limits<S>::quiet_NaN()), h_a(0), evaluations(0)
+		{
+			ensure(N > 0 and order > 0);
+		}
+
+		// K[n * m + i] = cgf(s[i], n) for 0 <= n < N, 0 <= i < m
+		void operator()(const S* s, S* K, size_t m)
+		{
+			for (size_t i = 0; i < m; ++i) {
+				ensure(-1 < s[i] and s[i] < 1);
+
+				S h = s[i] - s_a;
+				if (!(fabs(h) <= h_a)) { // also first point
+					unsigned p = plan(s, i, m);
+					if (p == 0) {
+						for (unsigned n = 0; n < N; ++n) {
+							K[n * m + i] = cgf(s[i], n);
+						}
+						continue;
+					}
+					anchor(s[i], p);
+					h = 0;
+				}
+				for (unsigned n = 0; n < N; ++n) {
+					// sum_j c[n + j] (n + j)!/(n! j!) h^j
+					S Kn = 0;
+					S C = binomial(n + order, n); // binomial(n + j, j) for j = order
+					for (unsigned j = order + 1; j-- > 0; ) {
+						Kn = Kn * h + C * c[n + j];
+						C = j ? C * j / (n + j) : C;
+					}
+					S n_ = 1;
+					for (unsigned k = 2; k <= n; ++k) {
+						n_ *= k;
+					}
+					K[n * m + i] = Kn * n_;
+				}
+			}
+		}
+
+		// K[n * m + i] = cgf(s[i], n) for 0 <= n < N and D[i] = v.sdf(s[i], x) for 0 <= i < m
+		void operator()(const S* s, S* K, size_t m, X x, X* D)
+		{
+			operator()(s, K, m);
+			sdf(s, x, D, m);
+		}
+
+		// D[i] = v.sdf(s[i], x) for 0 <= i < m
+		void sdf(const S* s, X x, X* D, size_t m) const
+		{
+			X u = 1 / (1 + exp(-x));
+			X lu = log(u * (1 - u));
+
+			for (size_t i = 0; i < m; ++i) {
+				D[i] = lu * gsl_sf_beta_inc(v.a + s[i], v.b - s[i], u);
+			}
+		}
+	};
+
+}
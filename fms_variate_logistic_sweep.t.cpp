@@ -0,0 +1,178 @@
+// fms_variate_logistic_sweep.t.cpp - test logistic values along sorted grids
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_logistic_sweep.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_variate_logistic_cdf_sweep()
+{
+	for (X a : { X(0.5), X(1), X(2.5) }) {
+		for (X b : { X(0.5), X(1), X(2.5) }) {
+			logistic<X> v(a, b);
+			for (X s : { X(0), X(0.3) }) {
+				// dense grid with a gap
+				std::vector<X> x;
+				for (X xi : range<X>(-10, 2, 0.01)) {
+					x.push_back(xi);
+				}
+				x.push_back(2);
+				for (X xi : range<X>(8, 12, 0.37)) {
+					x.push_back(xi);
+				}
+				std::vector<X> F(x.size());
+
+				cdf_sweep<X> sweep(v, s);
+				sweep(x.data(), F.data(), x.size());
+				for (size_t i = 0; i < x.size(); ++i) {
+					assert(fabs(F[i] - v.cdf(x[i], s)) < 1e-12);
+				}
+
+				// continues from the last anchor
+				X y[] = { 12, 12.1, 13 };
+				X G[3];
+				sweep(y, G, 3);
+				for (size_t i = 0; i < 3; ++i) {
+					assert(fabs(G[i] - v.cdf(y[i], s)) < 1e-12);
+				}
+			}
+		}
+	}
+	// second call starts before the last anchor
+	{
+		logistic<X> v(1.5, 2);
+		cdf_sweep<X> sweep(v);
+		X x[] = { 0, 1, 2, 3 }, F[4];
+		sweep(x, F, 4);
+		X y[] = { -2, -1 }, G[2];
+		sweep(y, G, 2);
+		for (size_t i = 0; i < 2; ++i) {
+			assert(fabs(G[i] - v.cdf(y[i])) < 1e-12);
+		}
+	}
+	// derivatives grow with a + b
+	for (auto [a, b] : { std::pair<X, X>(5, 50), std::pair<X, X>(20, 80), std::pair<X, X>(50, 50) }) {
+		logistic<X> v(a, b);
+		std::vector<X> x;
+		for (X xi : range<X>(-6, 6, 0.01)) {
+			x.push_back(xi);
+		}
+		std::vector<X> F(x.size());
+		for (X s : { X(0), X(0.1), X(-0.3) }) {
+			cdf_sweep<X> sweep(v, s);
+			sweep(x.data(), F.data(), x.size());
+			X err = 0;
+			for (size_t i = 0; i < x.size(); ++i) {
+				err = std::max(err, fabs(F[i] - v.cdf(x[i], s)));
+			}
+			assert(err < 2e-13);
+			assert(sweep.drift <= 1e-14);
+
+			// reset restores the initial reanchor
+			sweep.reset();
+			assert(sweep.drift == 0);
+			std::vector<X> G(x.size());
+			sweep(x.data(), G.data(), x.size());
+			assert(G == F);
+		}
+	}
+	// parameters are checked before any special functions are called
+	{
+		bool thrown = false;
+		try {
+			cdf_sweep<X> sweep(logistic<X>(1, 2), X(2));
+		}
+		catch (const std::exception&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	return 0;
+}
+int test_variate_logistic_cdf_sweep_d = test_variate_logistic_cdf_sweep<double>();
+
+template<class X>
+int test_variate_logistic_cgf_sweep()
+{
+	for (X a : { X(0.7), X(1), X(2.5) }) {
+		for (X b : { X(0.7), X(1), X(2.5) }) {
+			logistic<X> v(a, b);
+			unsigned N = 4;
+			auto s = range<X>(-0.5, 0.5, 0.01);
+			size_t m = s.size();
+			std::vector<X> K(N * m), D(m);
+
+			cgf_sweep<X> sweep(v, N);
+			sweep(&s[0], K.data(), m);
+			for (unsigned n = 0; n < N; ++n) {
+				for (size_t i = 0; i < m; ++i) {
+					X k = v.cgf(s[i], n);
+					assert(fabs(K[n * m + i] - k) <= 1e-11 * std::max(X(1), fabs(k)));
+				}
+			}
+
+			// unsorted ladder
+			X t[] = { 0.3, -0.2, 0.31, 0 };
+			X L[4 * 4];
+			sweep(t, L, 4);
+			for (unsigned n = 0; n < N; ++n) {
+				for (size_t i = 0; i < 4; ++i) {
+					X k = v.cgf(t[i], n);
+					assert(fabs(L[n * 4 + i] - k) <= 1e-11 * std::max(X(1), fabs(k)));
+				}
+			}
+
+			for (X x : { X(-2), X(0), X(1.5) }) {
+				sweep.sdf(&s[0], x, D.data(), m);
+				for (size_t i = 0; i < m; ++i) {
+					assert(D[i] == v.sdf(s[i], x));
+				}
+			}
+
+			// cgf, derivatives, and sdf in one call
+			std::vector<X> K_(N * m), D_(m);
+			sweep(&s[0], K_.data(), m, X(0.5), D_.data());
+			for (size_t i = 0; i < m; ++i) {
+				for (unsigned n = 0; n < N; ++n) {
+					X k = v.cgf(s[i], n);
+					assert(fabs(K_[n * m + i] - k) <= 1e-11 * std::max(X(1), fabs(k)));
+				}
+				assert(D_[i] == v.sdf(s[i], X(0.5)));
+			}
+		}
+	}
+
+	// work is shared on dense ladders and never exceeds direct evaluation
+	for (X a : { X(0.55), X(1), X(2.5) }) {
+		logistic<X> v(a, a);
+		unsigned N = 4;
+		for (size_t m : { 10, 30, 1000 }) {
+			std::vector<X> s(m), K(N * m);
+			for (size_t i = 0; i < m; ++i) {
+				s[i] = X(-0.5) + X(i) / (m - 1);
+			}
+			cgf_sweep<X> sweep(v, N);
+			sweep(s.data(), K.data(), m);
+			assert(sweep.evaluations <= N * m);
+			if (m == 1000) {
+				assert(sweep.evaluations < N * m / 4);
+			}
+			for (unsigned n = 0; n < N; ++n) {
+				for (size_t i = 0; i < m; ++i) {
+					X k = v.cgf(s[i], n);
+					assert(fabs(K[n * m + i] - k) <= 1e-11 * std::max(X(1), fabs(k)));
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+int test_variate_logistic_cgf_sweep_d = test_variate_logistic_cgf_sweep<double>();
@@ -1,6 +1,8 @@
 // fms_variate_normal.h - normal distribution
 #pragma once
 #include <cmath>
+#include <complex>
+#include <limits>
 #include <numbers>
 #include "fms_variate_interface.h"
 
@@ -54,5 +56,52 @@ namespace fms::variate {
 			return s * s / 2;
 		}
 
+		// Inverse of cdf(x, s) using Acklam's rational approximation and one Halley step
+		X cdf_inv(X p, S s = 0) const
+		{
+			static constexpr X a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+				1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+			static constexpr X b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+				6.680131188771972e+01, -1.328068155288572e+01 };
+			static constexpr X c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+				-2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+			static constexpr X d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+				3.754408661907416e+00 };
+			static constexpr X p_low = X(0.02425);
+
+			if (!(0 < p and p < 1)) {
+				return p == 0 ? -std::numeric_limits<X>::infinity()
+				     : p == 1 ? std::numeric_limits<X>::infinity() : std::numeric_limits<X>::quiet_NaN();
+			}
+
+			X x;
+			if (p_low <= p and p <= 1 - p_low) {
+				X q = p - X(0.5);
+				X r = q * q;
+				x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+				  / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+			}
+			else {
+				X q = sqrt(-2 * log(p < p_low ? p : 1 - p));
+				x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+				  / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+				if (p > p_low) {
+					x = -x;
+				}
+			}
+
+			X e = cdf_(x, 0) - p;
+			X u = e * M_SQRT2PI * exp(x * x / 2);
+			x -= u / (1 + x * u / 2);
+
+			return x + s;
+		}
+
+		// Characteristic function of X_s, E[exp(i u X_s)] = exp(i u s - u^2/2)
+		std::complex<X> cf(X u, S s = 0) const
+		{
+			return std::exp(std::complex<X>(-u * u / 2, u * s));
+		}
+
 	};
 }
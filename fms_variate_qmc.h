@@ -0,0 +1,181 @@
+// fms_variate_qmc.h - quasi-Monte Carlo variates
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "fms_ensure.h"
+
+namespace fms::variate {
+
+	// Sebastiano Vigna's splitmix64 for scrambling.
+	inline uint64_t splitmix64(uint64_t& x)
+	{
+		uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+		return z ^ (z >> 31);
+	}
+
+	static inline const char sobol_doc[] = R"xyzyx(
+Sobol low discrepancy sequence in up to 16 dimensions using the Joe-Kuo direction numbers.
+Points are generated in Gray code order so \(x_{n+1} = x_n \oplus v_{c}\) where \(c\) is
+the lowest zero bit of \(n\). Use skip(n) to start a block of points at index \(n\).
+A nonzero seed applies a random linear (Matousek) scramble and a random digital shift
+to each dimension. Scrambling preserves the net properties of the sequence.
+Coordinates are at the midpoint of 32 bit cells so they are in the open interval \((0,1)\).
+)xyzyx";
+	template<class X = double>
+	class sobol {
+		static constexpr unsigned bits = 32;
+		// degree s, coefficients a, and initial m_1, ..., m_s for dimensions 2 to 16
+		struct primitive {
+			unsigned s, a;
+			uint32_t m[6];
+		};
+		static constexpr primitive joe_kuo[] = {
+			{ 1, 0, { 1 } },
+			{ 2, 1, { 1, 3 } },
+			{ 3, 1, { 1, 3, 1 } },
+			{ 3, 2, { 1, 1, 1 } },
+			{ 4, 1, { 1, 1, 3, 3 } },
+			{ 4, 4, { 1, 3, 5, 13 } },
+			{ 5, 2, { 1, 1, 5, 5, 17 } },
+			{ 5, 4, { 1, 1, 5, 5, 5 } },
+			{ 5, 7, { 1, 1, 7, 11, 19 } },
+			{ 5, 11, { 1, 1, 5, 1, 1 } },
+			{ 5, 13, { 1, 1, 1, 3, 11 } },
+			{ 5, 14, { 1, 3, 5, 5, 31 } },
+			{ 6, 1, { 1, 3, 3, 9, 7, 49 } },
+			{ 6, 13, { 1, 1, 1, 15, 21, 21 } },
+			{ 6, 16, { 1, 3, 1, 13, 27, 49 } },
+		};
+
+		unsigned d;
+		std::vector<uint32_t> v; // v[j * bits + k] direction number k of dimension j
+		std::vector<uint32_t> shift, x;
+		uint64_t n; // index of next point
+	public:
+		static constexpr unsigned max_dimension = 1 + sizeof(joe_kuo) / sizeof(*joe_kuo);
+
+		sobol(unsigned dimension, uint64_t seed = 0)
+			: d(dimension), v(d * bits), shift(d, 0), x(d, 0), n(0)
+		{
+			ensure(0 < d and d <= max_dimension);
+
+			for (unsigned k = 0; k < bits; ++k) {
+				v[k] = uint32_t(1) << (bits - 1 - k);
+			}
+			for (unsigned j = 1; j < d; ++j) {
+				const primitive& p = joe_kuo[j - 1];
+				uint32_t* vj = v.data() + j * bits;
+				for (unsigned k = 0; k < p.s; ++k) {
+					vj[k] = p.m[k] << (bits - 1 - k);
+				}
+				for (unsigned k = p.s; k < bits; ++k) {
+					vj[k] = vj[k - p.s] ^ (vj[k - p.s] >> p.s);
+					for (unsigned i = 1; i < p.s; ++i) {
+						if ((p.a >> (p.s - 1 - i)) & 1) {
+							vj[k] ^= vj[k - i];
+						}
+					}
+				}
+			}
+
+			if (seed) {
+				for (unsigned j = 0; j < d; ++j) {
+					// lower triangular with unit diagonal in digit order, most significant bit first
+					uint32_t L[bits];
+					for (unsigned i = 0; i < bits; ++i) {
+						uint32_t above = i ? ~uint32_t(0) << (bits - i) : 0;
+						L[i] = (uint32_t(splitmix64(seed)) & above) | (uint32_t(1) << (bits - 1 - i));
+					}
+					for (unsigned k = 0; k < bits; ++k) {
+						uint32_t vk = v[j * bits + k], Lv = 0;
+						for (unsigned i = 0; i < bits; ++i) {
+							Lv |= uint32_t(std::popcount(L[i] & vk) & 1) << (bits - 1 - i);
+						}
+						v[j * bits + k] = Lv;
+					}
+					shift[j] = uint32_t(splitmix64(seed));
+				}
+			}
+
+			skip(0);
+		}
+
+		unsigned dimension() const
+		{
+			return d;
+		}
+		// index of the next point
+		uint64_t index() const
+		{
+			return n;
+		}
+
+		// Position at point n directly from its Gray code.
+		sobol& skip(uint64_t n_)
+		{
+			ensure(n_ < (uint64_t(1) << bits));
+
+			n = n_;
+			uint64_t g = n ^ (n >> 1);
+			for (unsigned j = 0; j < d; ++j) {
+				uint32_t xj = shift[j];
+				for (unsigned k = 0; k < bits; ++k) {
+					if ((g >> k) & 1) {
+						xj ^= v[j * bits + k];
+					}
+				}
+				x[j] = xj;
+			}
+
+			return *this;
+		}
+
+		// Write the next point to u[0], ..., u[d - 1].
+		void next(X* u)
+		{
+			static constexpr X scale = X(1) / (uint64_t(1) << bits);
+
+			for (unsigned j = 0; j < d; ++j) {
+				u[j] = (X(x[j]) + X(0.5)) * scale;
+			}
+
+			unsigned c = std::countr_one(n);
+			if (c < bits) {
+				for (unsigned j = 0; j < d; ++j) {
+					x[j] ^= v[j * bits + c];
+				}
+			}
+			++n;
+		}
+
+		// Write the next m points to u in row major order.
+		void block(X* u, size_t m)
+		{
+			for (size_t i = 0; i < m; ++i) {
+				next(u + i * d);
+			}
+		}
+		// Write the next m coordinates to u, m / d points in row major order.
+		// Fits the uniform generator interface of stream when d = 1.
+		void operator()(X* u, size_t m)
+		{
+			ensure(m % d == 0);
+
+			block(u, m / d);
+		}
+	};
+
+	// x[i] = v.cdf_inv(u[i], s) for 0 <= i < n, maps uniforms to variates of X_s.
+	template<class V, class X = typename V::xtype, class S = typename V::stype>
+	inline void cdf_inv(const V& v, const X* u, X* x, size_t n, S s = 0)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			x[i] = v.cdf_inv(u[i], s);
+		}
+	}
+
+}
@@ -0,0 +1,106 @@
+// fms_variate_qmc.t.cpp - test quasi-Monte Carlo variates
+#include <cassert>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_normal.h"
+#include "fms_variate_qmc.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_sobol()
+{
+	{
+		sobol<X> q(2);
+		X x0[] = { 0, .5, .75, .25, .375, .875, .625, .125 };
+		X x1[] = { 0, .5, .25, .75, .375, .875, .125, .625 };
+		X u[2];
+		for (size_t i = 0; i < 8; ++i) {
+			q.next(u);
+			assert(fabs(u[0] - x0[i]) < 1e-9);
+			assert(fabs(u[1] - x1[i]) < 1e-9);
+		}
+	}
+	for (uint64_t seed : { 0, 1, 2 }) {
+		unsigned d = sobol<X>::max_dimension;
+		unsigned m = 8; // 2^m points
+		size_t M = size_t(1) << m;
+		sobol<X> q(d, seed);
+		std::vector<X> u(M * d);
+		q.block(u.data(), M);
+		assert(q.index() == M);
+
+		// each coordinate has one point in every interval of length 2^-m
+		for (unsigned j = 0; j < d; ++j) {
+			std::vector<int> count(M, 0);
+			for (size_t i = 0; i < M; ++i) {
+				X uj = u[i * d + j];
+				assert(0 < uj and uj < 1);
+				++count[size_t(uj * M)];
+			}
+			for (size_t k = 0; k < M; ++k) {
+				assert(count[k] == 1);
+			}
+		}
+		// first two coordinates are a (0, m, 2)-net
+		for (unsigned i = 0; i <= m; ++i) {
+			size_t n0 = size_t(1) << i, n1 = size_t(1) << (m - i);
+			std::vector<int> count(M, 0);
+			for (size_t k = 0; k < M; ++k) {
+				++count[size_t(u[k * d] * n0) * n1 + size_t(u[k * d + 1] * n1)];
+			}
+			for (size_t k = 0; k < M; ++k) {
+				assert(count[k] == 1);
+			}
+		}
+
+		// skip ahead agrees with sequential generation
+		sobol<X> p(d, seed);
+		std::vector<X> w(d);
+		for (size_t i : { 0, 1, 37, 128, 255 }) {
+			p.skip(i).next(w.data());
+			for (unsigned j = 0; j < d; ++j) {
+				assert(w[j] == u[i * d + j]);
+			}
+		}
+	}
+
+	return 0;
+}
+int test_sobol_d = test_sobol<double>();
+
+template<class X>
+int test_qmc_normal()
+{
+	standard_normal<X> N;
+	{
+		for (X s : { X(0), X(0.5) }) {
+			for (X x : range<X>(-6, 5.5, 0.25)) { // 1 - p loses precision in the upper tail
+				X p = N.cdf(x, s);
+				assert(fabs(N.cdf_inv(p, s) - x) < 1e-9);
+			}
+		}
+		assert(N.cdf_inv(0) == -std::numeric_limits<X>::infinity());
+	}
+	{
+		size_t M = 1 << 12;
+		sobol<X> q(1, 7);
+		std::vector<X> u(M), x(M);
+		q.block(u.data(), M);
+		X s = 0.5;
+		cdf_inv(N, u.data(), x.data(), M, s);
+		X m = 0, m2 = 0;
+		for (X xi : x) {
+			m += xi;
+			m2 += (xi - s) * (xi - s);
+		}
+		m /= M;
+		m2 /= M;
+		assert(fabs(m - s) < 1e-3);
+		assert(fabs(m2 - 1) < 1e-2);
+	}
+
+	return 0;
+}
+int test_qmc_normal_d = test_qmc_normal<double>();
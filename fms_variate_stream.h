@@ -0,0 +1,228 @@
+// fms_variate_stream.h - Monte Carlo expectations from blocks of variates
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <random>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "fms_ensure.h"
+#include "fms_variate_qmc.h"
+
+namespace fms::variate {
+
+	// Uniform variates in (0, 1) with 53 random bits.
+	template<class X = double>
+	class uniform {
+		std::mt19937_64 g;
+	public:
+		uniform(uint64_t seed = 1)
+			: g(seed)
+		{ }
+
+		void operator()(X* u, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				u[i] = ((g() >> 11) + X(0.5)) * X(0x1p-53);
+			}
+		}
+	};
+
+	// Independent uniform generator for each seed.
+	template<class X = double>
+	struct make_uniform {
+		uniform<X> operator()(uint64_t seed) const
+		{
+			return uniform<X>(seed);
+		}
+	};
+
+	// Lazily produce blocks of variates of X_s from blocks of uniforms.
+	template<class V, class U = uniform<typename V::xtype>>
+	class stream {
+		typedef typename V::xtype X;
+		typedef typename V::stype S;
+		V v;
+		S s;
+		U u;
+		std::vector<X> x;
+	public:
+		stream(const V& v, S s = 0, U u = U{}, size_t block = 1024)
+			: v(v), s(s), u(std::move(u)), x(block)
+		{
+			ensure(block > 0);
+		}
+
+		// next block of variates, valid until the next call
+		std::span<const X> operator()()
+		{
+			u(x.data(), x.size());
+			cdf_inv(v, x.data(), x.data(), x.size(), s);
+
+			return std::span<const X>(x);
+		}
+	};
+
+	// Running means and centered second moments of samples y and control variates c.
+	template<class X = double>
+	struct moments {
+		size_t n = 0;
+		X y = 0, c = 0; // means
+		X yy = 0, cc = 0, yc = 0; // sums of centered squares and products
+
+		// Chan, Golub, and LeVeque pairwise update
+		moments& operator+=(const moments& m)
+		{
+			if (m.n == 0) {
+				return *this;
+			}
+			X n_ = X(n) + m.n;
+			X dy = m.y - y, dc = m.c - c;
+			X w = X(n) * m.n / n_;
+			y += dy * m.n / n_;
+			c += dc * m.n / n_;
+			yy += m.yy + dy * dy * w;
+			cc += m.cc + dc * dc * w;
+			yc += m.yc + dy * dc * w;
+			n += m.n;
+
+			return *this;
+		}
+
+		// Add a block using Kahan summation for the means and a second pass for the centered sums.
+		void add(const X* y_, const X* c_, size_t m)
+		{
+			if (m == 0) {
+				return;
+			}
+
+			auto mean = [m](const X* z) {
+				X sum = 0, e = 0;
+				for (size_t i = 0; i < m; ++i) {
+					X t = z[i] - e;
+					X sum_ = sum + t;
+					e = (sum_ - sum) - t;
+					sum = sum_;
+				}
+				return sum / m;
+			};
+
+			moments b;
+			b.n = m;
+			b.y = mean(y_);
+			b.c = c_ ? mean(c_) : 0;
+			for (size_t i = 0; i < m; ++i) {
+				X dy = y_[i] - b.y;
+				X dc = c_ ? c_[i] - b.c : 0;
+				b.yy += dy * dy;
+				b.cc += dc * dc;
+				b.yc += dy * dc;
+			}
+
+			*this += b;
+		}
+	};
+
+	template<class X = double>
+	struct estimate {
+		X value, error; // estimate and standard error
+		size_t n;
+		X beta; // control variate coefficient, 0 if none
+	};
+
+	static inline const char expectation_doc[] = R"xyzyx(
+Estimate \(E[f(X_s)]\) using \(n\) samples in blocks of variates of the share measure \(X_s\).
+The function is called on blocks, \(f(x, y)\) sets \(y_i = f(x_i)\) for \(0 \le i < |x|\), or on single
+variates if it is not invocable on blocks.
+Thread \(k\) draws uniforms from \(g(\text{seed}_k)\) with independent seeds, so \(g\) can return
+pseudo random or scrambled Sobol generators, and accumulates block moments that are merged
+at the end. The standard error assumes independent samples.
+If \(t\) is given then \(C = e^{tX_s}\) is used as a control variate with exact mean
+\(E[e^{tX_s}] = e^{\kappa(s + t) - \kappa(s)}\) and the estimate is
+\(\bar{Y} - \beta(\bar{C} - E[C])\) with \(\beta = \mathrm{Cov}(Y, C)/\mathrm{Var}(C)\).
+The cumulant must be defined and finite at \(s + t\) and \(s + 2t\) so \(C\) has finite variance.
+Both are checked before sampling.
+)xyzyx";
+	template<class V, class F, class X = typename V::xtype, class S = typename V::stype,
+		class G = make_uniform<typename V::xtype>>
+	inline estimate<X> expectation(const V& v, S s, const F& f, size_t n, unsigned threads = 1,
+		std::optional<typename V::stype> t = std::nullopt, uint64_t seed = 1, size_t block = 1024, const G& g = G{})
+	{
+		ensure(n > 1 and threads > 0 and block > 0);
+
+		X mu = 0; // E[C]
+		if (t) {
+			mu = exp(v.cgf(s + *t) - v.cgf(s));
+			// Var(C) is finite if E[C^2] = exp(kappa(s + 2t) - kappa(s)) is
+			ensure(std::isfinite(v.cgf(s + 2 * *t)));
+		}
+
+		std::vector<moments<X>> m(threads);
+		std::vector<std::exception_ptr> err(threads);
+		auto work = [&](unsigned k) {
+			try {
+				uint64_t seed_k = seed + k;
+				stream<V, decltype(g(seed_k))> xs(v, s, g(splitmix64(seed_k)), block);
+				std::vector<X> y(block), c(block);
+				size_t n_k = n / threads + (k < n % threads);
+				while (n_k) {
+					size_t b = std::min(n_k, block);
+					auto x = xs().first(b);
+					if constexpr (std::is_invocable_v<const F&, std::span<const X>, X*>) {
+						f(x, y.data());
+					}
+					else {
+						for (size_t i = 0; i < b; ++i) {
+							y[i] = f(x[i]);
+						}
+					}
+					if (t) {
+						for (size_t i = 0; i < b; ++i) {
+							c[i] = exp(*t * x[i]);
+						}
+					}
+					m[k].add(y.data(), t ? c.data() : nullptr, b);
+					n_k -= b;
+				}
+			}
+			catch (...) {
+				err[k] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> ts;
+		for (unsigned k = 1; k < threads; ++k) {
+			ts.emplace_back(work, k);
+		}
+		work(0);
+		for (auto& th : ts) {
+			th.join();
+		}
+		for (auto& e : err) {
+			if (e) {
+				std::rethrow_exception(e);
+			}
+		}
+
+		moments<X> M;
+		for (const auto& m_k : m) {
+			M += m_k;
+		}
+
+		estimate<X> e{ M.y, 0, M.n, 0 };
+		X var = M.yy;
+		if (t and M.cc > 0) {
+			e.beta = M.yc / M.cc;
+			e.value -= e.beta * (M.c - mu);
+			var -= M.yc * e.beta;
+		}
+		e.error = sqrt(std::max(var, X(0)) / (M.n - 1) / M.n);
+
+		return e;
+	}
+
+}
@@ -0,0 +1,87 @@
+// fms_variate_stream.t.cpp - test Monte Carlo expectations from blocks of variates
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_normal.h"
+#include "fms_variate_stream.h"
+
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_moments()
+{
+	{
+		std::vector<X> y = { 1, 2, 3, 4, 5, 6, 7 }, c = { 2, 1, 4, 3, 6, 5, 8 };
+		moments<X> m, m0, m1;
+		m.add(y.data(), c.data(), 7);
+		m0.add(y.data(), c.data(), 3);
+		m1.add(y.data() + 3, c.data() + 3, 4);
+		m0 += m1;
+		assert(m.n == 7 and m0.n == 7);
+		assert(m.y == 4 and fabs(m0.y - 4) < 1e-15);
+		assert(fabs(m.c - 29. / 7) < 1e-15 and fabs(m0.c - m.c) < 1e-15);
+		assert(m.yy == 28 and fabs(m0.yy - 28) < 1e-13);
+		assert(fabs(m0.cc - m.cc) < 1e-13);
+		assert(fabs(m0.yc - m.yc) < 1e-13);
+	}
+
+	return 0;
+}
+int test_moments_d = test_moments<double>();
+
+template<class X>
+int test_expectation()
+{
+	standard_normal<X> N;
+	{
+		stream<standard_normal<X>> xs(N, X(0.5), uniform<X>(1), 100);
+		auto x = xs();
+		assert(x.size() == 100);
+		X x0 = x[0];
+		auto x_ = xs(); // reuses the block
+		assert(x_.data() == x.data());
+		assert(x_[0] != x0);
+	}
+	{
+		X s = 0.3;
+		auto id = [](std::span<const X> x, X* y) { std::copy(x.begin(), x.end(), y); };
+		auto e = expectation(N, s, id, 100000, 4);
+		assert(e.n == 100000);
+		assert(fabs(e.value - s) < 4 * e.error);
+		assert(fabs(e.error - 1 / sqrt(X(100000))) < 1e-4);
+	}
+	{
+		// E[(X_s - k)^+] = (s - k) Phi(s - k) + phi(s - k)
+		X s = 0.2, k = 0.5;
+		auto call = [k](std::span<const X> x, X* y) {
+			for (size_t i = 0; i < x.size(); ++i) {
+				y[i] = x[i] > k ? x[i] - k : 0;
+			}
+		};
+		X C = (s - k) * N.cdf(s - k, 0) + N.pdf(s - k, 0);
+		auto e = expectation(N, s, call, 100000, 3);
+		assert(fabs(e.value - C) < 4 * e.error);
+		auto e_ = expectation(N, s, call, 100000, 3, X(1));
+		assert(fabs(e_.value - C) < 4 * e_.error);
+		assert(e_.error < e.error);
+		assert(e_.beta > 0);
+		// scrambled Sobol uniforms
+		auto q = [](uint64_t seed) { return sobol<X>(1, seed); };
+		auto e_q = expectation(N, s, call, 1 << 16, 2, std::nullopt, 1, 1024, q);
+		assert(fabs(e_q.value - C) < 1e-3);
+	}
+	{
+		// exact control variate
+		X s = -0.1;
+		auto e = expectation(N, s, [](X x) { return exp(x); }, 10000, 2, X(1));
+		assert(fabs(e.value - exp(N.cgf(s + 1) - N.cgf(s))) < 1e-12);
+		assert(e.error < 1e-12);
+		assert(fabs(e.beta - 1) < 1e-12);
+	}
+
+	return 0;
+}
+int test_expectation_d = test_expectation<double>();
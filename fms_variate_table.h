@@ -0,0 +1,171 @@
+// fms_variate_table.h - tables built by forked worker processes in shared memory
+#pragma once
+#ifdef __unix__
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "fms_ensure.h"
+
+namespace fms::variate {
+
+	static inline const char table_doc[] = R"xyzyx(
+Table of \(f(p, x_j, s_k)\) for parameter sets \(0 \le p < n_p\), \(x\) grid, and \(s\) grid.
+Rows \((p, k)\) of length \(n_x\) are sharded round robin over forked worker processes that write
+directly into an anonymous shared memory arena and set a bit in a completion bitmap when a row
+is finished. Each worker has its own copy of the process state, including GSL, so workers do not
+contend with each other. The parent can read finished rows while the build is running and wait()
+reaps the workers. cancel() terminates unfinished workers and the destructor cancels, so a table
+destroyed early, for example during stack unwinding, does not wait for the build.
+Requires fork and mmap. Only the forking thread is copied into a worker, so locks held by other
+threads of the parent stay locked in the child. Construct tables before starting threads, or make
+sure \(f\) does not use locks, allocators, or I/O that other threads of the parent might hold.
+)xyzyx";
+	template<class X = double, class S = X>
+	class table {
+		using word = std::atomic<uint64_t>;
+		static_assert(word::is_always_lock_free);
+
+		size_t np, nx, ns;
+		size_t words; // bitmap words
+		size_t bytes; // arena size
+		void* arena;
+		word* done; // completion bitmap of rows p * ns + k
+		X* value; // value[(p * ns + k) * nx + j]
+		std::vector<pid_t> workers;
+		bool ok;
+
+		size_t row_index(size_t p, size_t k) const
+		{
+			ensure(p < np and k < ns);
+
+			return p * ns + k;
+		}
+	public:
+		// Fork workers computing f(p, x[j], s[k]) and return without waiting.
+		template<class F>
+		table(const F& f, size_t np, const std::vector<X>& x, const std::vector<S>& s, unsigned nworkers)
+			: np(np), nx(x.size()), ns(s.size()), words((np * ns + 63) / 64), arena(MAP_FAILED), ok(true)
+		{
+			ensure(np > 0 and nx > 0 and ns > 0);
+			ensure(nworkers > 0);
+
+			bytes = words * sizeof(word) + np * ns * nx * sizeof(X);
+			arena = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+			ensure(arena != MAP_FAILED);
+
+			done = static_cast<word*>(arena);
+			for (size_t i = 0; i < words; ++i) {
+				new (done + i) word(0);
+			}
+			value = reinterpret_cast<X*>(done + words);
+
+			size_t rows = np * ns;
+			for (unsigned w = 0; w < nworkers and w < rows; ++w) {
+				pid_t pid = fork();
+				if (pid == 0) {
+					int status = 0;
+					try {
+						for (size_t r = w; r < rows; r += nworkers) {
+							size_t p = r / ns, k = r % ns;
+							X* v = value + r * nx;
+							for (size_t j = 0; j < nx; ++j) {
+								v[j] = f(p, x[j], s[k]);
+							}
+							done[r / 64].fetch_or(uint64_t(1) << (r % 64), std::memory_order_release);
+						}
+					}
+					catch (...) {
+						status = 1;
+					}
+					_exit(status);
+				}
+				if (pid < 0) {
+					ok = false;
+					break;
+				}
+				workers.push_back(pid);
+			}
+			if (!ok) {
+				cancel();
+				munmap(arena, bytes);
+				ensure(!"fork failed");
+			}
+		}
+		table(const table&) = delete;
+		table& operator=(const table&) = delete;
+		~table()
+		{
+			cancel();
+			munmap(arena, bytes);
+		}
+
+		// Reap all workers. Returns false if any worker failed or could not be reaped.
+		bool wait()
+		{
+			for (pid_t pid : workers) {
+				int status = 0;
+				pid_t r;
+				while ((r = waitpid(pid, &status, 0)) < 0 and errno == EINTR)
+					;
+				ok = ok and r == pid and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+			}
+			workers.clear();
+
+			return ok;
+		}
+
+		// Terminate and reap workers that have not finished. Returns false if any worker did not finish.
+		bool cancel()
+		{
+			for (pid_t pid : workers) {
+				kill(pid, SIGTERM);
+			}
+
+			return wait();
+		}
+
+		bool ready(size_t p, size_t k) const
+		{
+			size_t r = row_index(p, k);
+
+			return (done[r / 64].load(std::memory_order_acquire) >> (r % 64)) & 1;
+		}
+		// number of finished rows
+		size_t completed() const
+		{
+			size_t n = 0;
+			for (size_t i = 0; i < words; ++i) {
+				n += std::popcount(done[i].load(std::memory_order_acquire));
+			}
+
+			return n;
+		}
+		size_t rows() const
+		{
+			return np * ns;
+		}
+
+		// f(p, x[j], s[k]) for 0 <= j < nx, or nullptr if the row is not finished
+		const X* row(size_t p, size_t k) const
+		{
+			return ready(p, k) ? value + row_index(p, k) * nx : nullptr;
+		}
+		std::optional<X> operator()(size_t p, size_t j, size_t k) const
+		{
+			ensure(j < nx);
+			const X* v = row(p, k);
+
+			return v ? std::optional<X>(v[j]) : std::nullopt;
+		}
+	};
+
+}
+#endif // __unix__
@@ -0,0 +1,77 @@
+// fms_variate_table.t.cpp - test tables built by forked worker processes
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include "fms_test.h"
+#include "fms_variate_normal.h"
+#include "fms_variate_table.h"
+
+#ifdef __unix__
+using namespace fms::test;
+using namespace fms::variate;
+
+template<class X>
+int test_variate_table()
+{
+	standard_normal<X> N;
+	std::vector<X> x, s = { X(-0.1), X(0), X(0.2) };
+	for (X xi : range<X>(-3, 3, 0.25)) {
+		x.push_back(xi);
+	}
+	std::vector<X> sigma = { X(0.5), X(1), X(1.5), X(2), X(3) };
+	auto f = [&N, &sigma](size_t p, X x, X s) { return N.cdf(x / sigma[p], s); };
+
+	{
+		table<X> t(f, sigma.size(), x, s, 3);
+		assert(t.rows() == sigma.size() * s.size());
+		assert(t.completed() <= t.rows());
+		assert(t.wait());
+		assert(t.completed() == t.rows());
+		for (size_t p = 0; p < sigma.size(); ++p) {
+			for (size_t k = 0; k < s.size(); ++k) {
+				assert(t.ready(p, k));
+				const X* v = t.row(p, k);
+				for (size_t j = 0; j < x.size(); ++j) {
+					assert(v[j] == f(p, x[j], s[k]));
+					assert(*t(p, j, k) == v[j]);
+				}
+			}
+		}
+	}
+	{
+		// worker 1 of 2 fails on its first row
+		auto g = [&f](size_t p, X x, X s) {
+			if (p == 0 and s == 0) {
+				throw std::runtime_error("fail");
+			}
+			return f(p, x, s);
+		};
+		table<X> t(g, sigma.size(), x, s, 2);
+		assert(!t.wait());
+		assert(!t.ready(0, 1));
+		assert(!t(0, 0, 1));
+		assert(t.ready(0, 0));
+		assert(t.completed() < t.rows());
+	}
+	{
+		// cancel does not wait for a slow build
+		auto slow = [&f](size_t p, X x, X s) {
+			usleep(10000);
+			return f(p, x, s);
+		};
+		auto t0 = std::chrono::steady_clock::now();
+		{
+			table<X> t(slow, sigma.size(), x, s, 2);
+			assert(t.completed() < t.rows());
+		}
+		assert(std::chrono::steady_clock::now() - t0 < std::chrono::seconds(1));
+		table<X> t(slow, sigma.size(), x, s, 2);
+		assert(!t.cancel());
+		assert(t.completed() < t.rows());
+	}
+
+	return 0;
+}
+int test_variate_table_d = test_variate_table<double>();
+#endif // __unix__